@@ -0,0 +1,62 @@
+#pragma once
+#include "../maze/grid.h"
+#include "../../rng.h"
+
+// Directions (indexes into dirs) from room (x, y) to a neighbouring room
+// inside [x0, x1] x [y0, y1] that is still walled in. Returns the number of
+// candidates written.
+static inline int MazeCandidates(const Grid *maze, int x, int y, int x0, int y0, int x1, int y1, int out[4]) {
+    int k = 0;
+    for (int i = 0; i < 4; i++) {
+        int nx = x + dirs[i][0] * 2;
+        int ny = y + dirs[i][1] * 2;
+        if (nx >= x0 && nx <= x1 && ny >= y0 && ny <= y1 && grid_get(maze, nx, ny) == WALL) {
+            out[k++] = i;
+        }
+    }
+    return k;
+}
+
+// Iterative recursive backtracker over the rooms (odd cells) of the region
+// [x0, x1] x [y0, y1], starting at room (x, y). Each stack frame only stores
+// the 2-bit direction it was entered from (32 frames per word, heap
+// allocated), so depth is bounded by memory rather than the C stack.
+// Untried directions are rediscovered from the grid on every resume, which
+// makes the carving order a per-call random choice instead of a shared
+// shuffled table. Never reads or writes outside the region, so disjoint
+// regions can be carved concurrently.
+static void GenerateMazeRegion(Grid *maze, int x, int y, int x0, int y0, int x1, int y1, Rng *rng) {
+    qol_list(uint64_t) stack = {0};
+    size_t depth = 0;
+    grid_set(maze, x, y, PATH);
+
+    while (true) {
+        int cand[4];
+        int k = MazeCandidates(maze, x, y, x0, y0, x1, y1, cand);
+        if (k == 0) {
+            if (depth == 0) break;
+            depth--;
+            int d = (int)((stack.data[depth >> 5] >> ((depth & 31) * 2)) & 3);
+            x -= dirs[d][0] * 2;
+            y -= dirs[d][1] * 2;
+            continue;
+        }
+
+        int d = cand[k > 1 ? rng_below(rng, k) : 0];
+        grid_set(maze, x + dirs[d][0], y + dirs[d][1], PATH);
+        x += dirs[d][0] * 2;
+        y += dirs[d][1] * 2;
+        grid_set(maze, x, y, PATH);
+
+        if ((depth >> 5) >= stack.len) qol_push(&stack, 0);
+        uint64_t *w = &stack.data[depth >> 5];
+        *w = (*w & ~((uint64_t)3 << ((depth & 31) * 2))) | ((uint64_t)d << ((depth & 31) * 2));
+        depth++;
+    }
+    qol_release(&stack);
+}
+
+// Carve a perfect maze over the whole grid, starting at room (x, y)
+void GenerateMaze(Grid *maze, int x, int y, Rng *rng) {
+    GenerateMazeRegion(maze, x, y, 1, 1, maze->N - 2, maze->N - 2, rng);
+}
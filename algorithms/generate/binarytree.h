@@ -0,0 +1,105 @@
+#pragma once
+#include "../maze/grid.h"
+#include "../../rng.h"
+
+// Word-parallel binary-tree and sidewinder generators. Both carve one room
+// row at a time and only ever look at the row they are on, so they can work
+// on whole 64-bit grid words: rooms sit on the odd bits of a word (64 is
+// even, so x and its bit have the same parity) and a random word decides
+// 32 rooms at once. Every row of the grid is written outright, borders and
+// padding included, so the grid needs no grid_clear() first.
+//
+// The mazes are perfect but heavily biased: binary tree has a straight
+// corridor along the top row and the right column, sidewinder along the top
+// row only. They are meant for bulk corpora, where throughput matters more
+// than texture.
+#define ROOM_BITS 0xaaaaaaaaaaaaaaaaull
+
+// Odd bits of word w that are rooms of an N-wide grid (x in [1, N - 2])
+static inline uint64_t MazeRoomMask(int N, int w) {
+    int lo = w * 64, hi = N - 2;
+    if (hi < lo) return 0;
+    if (hi - lo >= 63) return ROOM_BITS;
+    return ROOM_BITS & ((2ull << (hi - lo)) - 1);
+}
+
+// Room row y opened at its rooms and at the walls east of the rooms in east
+// (a bit set at room x opens x + 1, which may be bit 0 of the next word)
+static inline void MazeCarveRoomRow(Grid *maze, int y, const uint64_t *east) {
+    uint64_t *row = grid_row(maze, y);
+    uint64_t carry = 0;
+    for (int w = 0; w < maze->stride; w++) {
+        row[w] = ~(MazeRoomMask(maze->N, w) | east[w] << 1 | carry);
+        carry = east[w] >> 63;
+    }
+}
+
+static inline void MazeFillRow(Grid *maze, int y) {
+    memset(grid_row(maze, y), 0xff, (size_t)maze->stride * sizeof(uint64_t));
+}
+
+// Binary tree: every room opens north or east at random, the top row only
+// east and the right column only north (the top-right room is the root).
+// One random word covers two words of rooms (its odd bits, then its even
+// bits shifted up).
+static void GenerateMazeBinaryTree(Grid *maze, Rng *rng) {
+    int N = maze->N;
+    int stride = maze->stride;
+    int lastWord = (N - 2) >> 6;
+    uint64_t lastRoom = (uint64_t)1 << ((N - 2) & 63);
+    uint64_t *east = malloc((size_t)stride * sizeof(uint64_t));
+
+    MazeFillRow(maze, 0);
+    for (int y = 1; y < N - 1; y += 2) {
+        uint64_t *above = grid_row(maze, y - 1);
+        uint64_t r = 0;
+        for (int w = 0; w < stride; w++) {
+            uint64_t rooms = MazeRoomMask(N, w);
+            if (!(w & 1)) r = rng_next(rng);
+            uint64_t north = y == 1 ? 0 : (w & 1 ? r << 1 : r) & rooms;
+            if (w == lastWord) north |= lastRoom;
+            east[w] = rooms & ~north;
+            if (w == lastWord) east[w] &= ~lastRoom;
+            if (y > 1) above[w] = ~north;
+        }
+        MazeCarveRoomRow(maze, y, east);
+    }
+    MazeFillRow(maze, N - 1);
+    free(east);
+}
+
+// Sidewinder: in each room row below the top, runs of rooms are joined east
+// (each room continues its run with probability 1/2, the last one always
+// stops) and every run opens north from one of its rooms, chosen uniformly.
+// The east joins are word-parallel; the north picks cost one draw per run.
+static void GenerateMazeSidewinder(Grid *maze, Rng *rng) {
+    int N = maze->N;
+    int stride = maze->stride;
+    int lastWord = (N - 2) >> 6;
+    uint64_t lastRoom = (uint64_t)1 << ((N - 2) & 63);
+    uint64_t *east = malloc((size_t)stride * sizeof(uint64_t));
+
+    MazeFillRow(maze, 0);
+    for (int y = 1; y < N - 1; y += 2) {
+        uint64_t *above = grid_row(maze, y - 1);
+        int runStart = 1;
+        uint64_t r = 0;
+        for (int w = 0; w < stride; w++) {
+            uint64_t rooms = MazeRoomMask(N, w);
+            if (!(w & 1)) r = rng_next(rng);
+            east[w] = y == 1 ? rooms : (w & 1 ? r << 1 : r) & rooms;
+            if (w == lastWord) east[w] &= ~lastRoom;
+            if (y == 1) continue;
+            above[w] = ~0ull;
+            for (uint64_t ends = rooms & ~east[w]; ends; ends &= ends - 1) {
+                int x = w * 64 + __builtin_ctzll(ends);
+                int pick = runStart + 2 * (int)rng_below(rng, (uint32_t)((x - runStart) / 2 + 1));
+                above[pick >> 6] &= ~((uint64_t)1 << (pick & 63));
+                runStart = x + 2;
+            }
+        }
+        MazeCarveRoomRow(maze, y, east);
+    }
+    MazeFillRow(maze, N - 1);
+    free(east);
+}
@@ -0,0 +1,48 @@
+#pragma once
+#include "../maze/grid.h"
+#include "../../rng.h"
+
+// Uniform draw in [0, 1) from the top 53 bits
+static inline double BraidChance(Rng *rng) {
+    return (double)(rng_next(rng) >> 11) * 0x1.0p-53;
+}
+
+// Braid a perfect maze in place with one row-major pass over the rooms.
+// Each dead end is opened with probability deadEnds, through a wall to a
+// neighbouring dead end when there is one (that removes two at once),
+// otherwise to a random walled-off neighbour. Independently, the wall to the
+// right of and below each room is knocked out with probability loops, which
+// adds cycles all over the maze rather than only at former dead ends. Every
+// room is visited once with constant work, and the same rng state gives the
+// same result.
+void BraidMaze(Grid *maze, Rng *rng, double deadEnds, double loops) {
+    int N = maze->N;
+    for (int y = 1; y < N - 1; y += 2) {
+        for (int x = 1; x < N - 1; x += 2) {
+            int closed[4], k = 0, open = 0;
+            for (int d = 0; d < 4; d++) {
+                int rx = x + 2 * dirs[d][0], ry = y + 2 * dirs[d][1];
+                if (rx < 1 || rx > N - 2 || ry < 1 || ry > N - 2) continue;
+                if (grid_get(maze, x + dirs[d][0], y + dirs[d][1]) == PATH) open++;
+                else closed[k++] = d;
+            }
+
+            if (open == 1 && k > 0 && BraidChance(rng) < deadEnds) {
+                int pick = -1;
+                for (int i = 0; i < k && pick < 0; i++) {
+                    int rx = x + 2 * dirs[closed[i]][0], ry = y + 2 * dirs[closed[i]][1];
+                    int exits = 0;
+                    for (int d = 0; d < 4; d++) exits += grid_get(maze, rx + dirs[d][0], ry + dirs[d][1]) == PATH;
+                    if (exits == 1) pick = closed[i];
+                }
+                if (pick < 0) pick = closed[k > 1 ? rng_below(rng, k) : 0];
+                grid_set(maze, x + dirs[pick][0], y + dirs[pick][1], PATH);
+            }
+
+            if (loops > 0.0) {
+                if (x + 2 < N - 1 && BraidChance(rng) < loops) grid_set(maze, x + 1, y, PATH);
+                if (y + 2 < N - 1 && BraidChance(rng) < loops) grid_set(maze, x, y + 1, PATH);
+            }
+        }
+    }
+}
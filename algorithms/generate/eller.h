@@ -0,0 +1,136 @@
+#pragma once
+#include "../maze/gridio.h"
+#include "../../rng.h"
+
+// Eller's algorithm, one room row at a time. Only the set labels of the
+// current room row (plus O(width) scratch) are kept, so the maze height is
+// unbounded and memory is independent of it. Rows are handed to a
+// MazeRowSink as soon as they are final.
+typedef struct {
+    int width;          // grid cells per row (odd)
+    int rooms;          // rooms per row
+    int stride;         // 64-bit words per row
+    int *label;         // set label per room of the current room row, 0..rooms-1
+    int *parent;        // union-find over labels while joining the row
+    int *count;         // rooms seen per set (reservoir sampling)
+    int *pick;          // room forced to connect down, per set
+    uint64_t *roomRow;  // grid row through the rooms
+    uint64_t *downRow;  // grid row below it
+    Rng rng;
+    int y;              // next grid row to emit
+} EllerGen;
+
+static inline void eller_init(EllerGen *e, int width, uint64_t seed) {
+    e->width = width;
+    e->rooms = (width - 1) / 2;
+    e->stride = (width + 63) / 64;
+    e->label = malloc((size_t)e->rooms * sizeof(int));
+    e->parent = malloc((size_t)e->rooms * sizeof(int));
+    e->count = malloc((size_t)e->rooms * sizeof(int));
+    e->pick = malloc((size_t)e->rooms * sizeof(int));
+    e->roomRow = malloc((size_t)e->stride * sizeof(uint64_t));
+    e->downRow = malloc((size_t)e->stride * sizeof(uint64_t));
+    for (int i = 0; i < e->rooms; i++) e->label[i] = i;
+    rng_seed(&e->rng, seed);
+    e->y = 0;
+}
+
+static inline void eller_free(EllerGen *e) {
+    free(e->label);
+    free(e->parent);
+    free(e->count);
+    free(e->pick);
+    free(e->roomRow);
+    free(e->downRow);
+}
+
+static inline int eller_find(EllerGen *e, int a) {
+    while (e->parent[a] != a) {
+        e->parent[a] = e->parent[e->parent[a]];
+        a = e->parent[a];
+    }
+    return a;
+}
+
+static inline void eller_open(uint64_t *row, int x) {
+    row[x >> 6] &= ~((uint64_t)1 << (x & 63));
+}
+
+static inline bool eller_is_open(const uint64_t *row, int x) {
+    return !((row[x >> 6] >> (x & 63)) & 1);
+}
+
+// Emit the next room row and the row below it. On the first call the top
+// border row is emitted first. With last set, every remaining set is merged
+// and the row below is the closed bottom border.
+static void eller_next(EllerGen *e, bool last, MazeRowSink sink, void *user) {
+    size_t bytes = (size_t)e->stride * sizeof(uint64_t);
+    if (e->y == 0) {
+        memset(e->downRow, 0xff, bytes);
+        sink(user, e->y++, e->downRow, e->stride);
+    }
+
+    // horizontal joins between neighbouring rooms of different sets
+    memset(e->roomRow, 0xff, bytes);
+    for (int i = 0; i < e->rooms; i++) {
+        e->parent[i] = i;
+        eller_open(e->roomRow, 2 * i + 1);
+    }
+    for (int i = 0; i + 1 < e->rooms; i++) {
+        int a = eller_find(e, e->label[i]);
+        int b = eller_find(e, e->label[i + 1]);
+        if (a != b && (last || (rng_next(&e->rng) >> 63))) {
+            e->parent[b] = a;
+            eller_open(e->roomRow, 2 * i + 2);
+        }
+    }
+    for (int i = 0; i < e->rooms; i++) e->label[i] = eller_find(e, e->label[i]);
+    sink(user, e->y++, e->roomRow, e->stride);
+
+    memset(e->downRow, 0xff, bytes);
+    if (last) {
+        sink(user, e->y++, e->downRow, e->stride);
+        return;
+    }
+
+    // vertical joins: random ones, plus one reservoir-sampled room per set
+    for (int i = 0; i < e->rooms; i++) e->count[i] = 0;
+    for (int i = 0; i < e->rooms; i++) {
+        int s = e->label[i];
+        e->count[s]++;
+        if (rng_below(&e->rng, e->count[s]) == 0) e->pick[s] = i;
+        if (rng_next(&e->rng) >> 63) eller_open(e->downRow, 2 * i + 1);
+    }
+    for (int i = 0; i < e->rooms; i++) {
+        if (e->pick[e->label[i]] == i) eller_open(e->downRow, 2 * i + 1);
+    }
+    sink(user, e->y++, e->downRow, e->stride);
+
+    // carry labels down, give unconnected rooms fresh sets and renumber so
+    // labels stay within 0..rooms-1 (count doubles as the remap table)
+    for (int i = 0; i < e->rooms; i++) e->count[i] = -1;
+    int next = 0;
+    for (int i = 0; i < e->rooms; i++) {
+        if (eller_is_open(e->downRow, 2 * i + 1)) {
+            int s = e->label[i];
+            if (e->count[s] < 0) e->count[s] = next++;
+            e->label[i] = e->count[s];
+        } else {
+            e->label[i] = next++;
+        }
+    }
+}
+
+// Stream a perfect width x height maze (both odd) into sink
+void GenerateMazeStream(int width, int height, uint64_t seed, MazeRowSink sink, void *user) {
+    EllerGen e;
+    eller_init(&e, width, seed);
+    int roomRows = (height - 1) / 2;
+    for (int r = 0; r < roomRows; r++) eller_next(&e, r == roomRows - 1, sink, user);
+    eller_free(&e);
+}
+
+// Eller's algorithm into an in-memory grid
+void GenerateMazeEller(Grid *maze, Rng *rng) {
+    GenerateMazeStream(maze->N, maze->N, rng_next(rng), grid_row_sink, maze);
+}
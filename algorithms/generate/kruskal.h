@@ -0,0 +1,75 @@
+#pragma once
+#include "../maze/grid.h"
+#include "../../rng.h"
+#include "unionfind.h"
+
+// Randomised Kruskal: every wall between two neighbouring rooms is an edge
+// in one flat array (horizontal edges first, then vertical ones). The array
+// is shuffled once and walls are knocked down whenever they join two
+// different union-find sets, which yields a uniform-looking spanning tree
+// with many short dead ends. Edge ids are uint32_t while they fit (up to
+// N = 92681) and uint64_t past that; counts are 64-bit throughout.
+void GenerateMazeKruskal(Grid *maze, Rng *rng) {
+    int R = (maze->N - 1) / 2;
+    if (R <= 0) return;
+    uint64_t rooms = (uint64_t)R * (uint64_t)R;
+    uint64_t horiz = (uint64_t)R * (uint64_t)(R - 1);
+    uint64_t count = 2 * horiz;
+    bool wide = count > UINT32_MAX;
+
+    void *edges = malloc((size_t)count * (wide ? sizeof(uint64_t) : sizeof(uint32_t)));
+    if (count && !edges) {
+        qol_error("Kruskal out of memory (%llu edges)\n", (unsigned long long)count);
+        abort();
+    }
+    uint32_t *narrow = edges;
+    uint64_t *broad = edges;
+    for (uint64_t e = 0; e < count; e++) {
+        if (wide) broad[e] = e;
+        else narrow[e] = (uint32_t)e;
+    }
+    for (uint64_t i = count; i > 1; i--) {
+        uint64_t r = rng_below64(rng, i);
+        if (wide) {
+            uint64_t t = broad[i - 1];
+            broad[i - 1] = broad[r];
+            broad[r] = t;
+        } else {
+            uint32_t t = narrow[i - 1];
+            narrow[i - 1] = narrow[r];
+            narrow[r] = t;
+        }
+    }
+
+    for (int y = 1; y < maze->N - 1; y += 2) {
+        for (int x = 1; x < maze->N - 1; x += 2) grid_set(maze, x, y, PATH);
+    }
+
+    UnionFind uf;
+    uf_init(&uf, (size_t)rooms);
+    uint64_t joined = 0;
+    for (uint64_t i = 0; i < count && joined < rooms - 1; i++) {
+        uint64_t e = wide ? broad[i] : narrow[i];
+        int cx, cy, dx, dy;
+        if (e < horiz) {
+            cx = (int)(e % (uint64_t)(R - 1));
+            cy = (int)(e / (uint64_t)(R - 1));
+            dx = 1;
+            dy = 0;
+        } else {
+            e -= horiz;
+            cx = (int)(e % (uint64_t)R);
+            cy = (int)(e / (uint64_t)R);
+            dx = 0;
+            dy = 1;
+        }
+        uint32_t a = (uint32_t)cy * (uint32_t)R + (uint32_t)cx;
+        uint32_t b = (uint32_t)(cy + dy) * (uint32_t)R + (uint32_t)(cx + dx);
+        if (uf_union(&uf, a, b)) {
+            grid_set(maze, 2 * cx + 1 + dx, 2 * cy + 1 + dy, PATH);
+            joined++;
+        }
+    }
+    uf_free(&uf);
+    free(edges);
+}
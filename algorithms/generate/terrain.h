@@ -0,0 +1,57 @@
+#pragma once
+#include "../maze/costs.h"
+#include "../../rng.h"
+
+// Value noise: random lattice values every `period` cells, smoothstep
+// interpolated in between. Adds amplitude * noise(x, y) to out.
+static void TerrainOctave(float *out, int N, int period, float amplitude, Rng *rng) {
+    int L = N / period + 2;
+    float *lattice = malloc((size_t)L * L * sizeof(float));
+    for (int i = 0; i < L * L; i++) lattice[i] = (float)(rng_next(rng) >> 40) / (float)(1 << 24);
+
+    for (int y = 0; y < N; y++) {
+        int ly = y / period;
+        float fy = (float)(y % period) / (float)period;
+        fy = fy * fy * (3.0f - 2.0f * fy);
+        for (int x = 0; x < N; x++) {
+            int lx = x / period;
+            float fx = (float)(x % period) / (float)period;
+            fx = fx * fx * (3.0f - 2.0f * fx);
+            float a = lattice[ly * L + lx], b = lattice[ly * L + lx + 1];
+            float c = lattice[(ly + 1) * L + lx], d = lattice[(ly + 1) * L + lx + 1];
+            float top = a + (b - a) * fx;
+            float bottom = c + (d - c) * fx;
+            out[(size_t)y * N + x] += amplitude * (top + (bottom - top) * fy);
+        }
+    }
+    free(lattice);
+}
+
+// Fill the cost plane with fractal value noise (octaves from N/4 down to 2
+// cells, each half the amplitude of the last) mapped onto 1..maxCost.
+// Produces smooth "hills" of expensive terrain with cheap valleys between,
+// so cheapest paths bend away from the straight line.
+void GenerateTerrainCosts(CostGrid *costs, Rng *rng, int maxCost) {
+    int N = costs->N;
+    if (maxCost < 1) maxCost = 1;
+    if (maxCost > 255) maxCost = 255;
+    float *noise = calloc((size_t)N * N, sizeof(float));
+
+    float amplitude = 1.0f;
+    for (int period = N / 4 > 2 ? N / 4 : 2; period >= 2; period /= 2) {
+        TerrainOctave(noise, N, period, amplitude, rng);
+        amplitude *= 0.5f;
+    }
+
+    float lo = noise[0], hi = noise[0];
+    for (size_t i = 1; i < (size_t)N * N; i++) {
+        if (noise[i] < lo) lo = noise[i];
+        if (noise[i] > hi) hi = noise[i];
+    }
+    float scale = hi > lo ? (float)(maxCost - 1) / (hi - lo) : 0.0f;
+    for (size_t i = 0; i < (size_t)N * N; i++) {
+        costs->cost[i] = (uint8_t)(1 + (int)((noise[i] - lo) * scale + 0.5f));
+    }
+    free(noise);
+    cost_grid_update_min(costs);
+}
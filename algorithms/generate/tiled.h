@@ -0,0 +1,110 @@
+#pragma once
+#include "backtracker.h"
+#include "unionfind.h"
+
+// Cells per tile side. A multiple of 64 so that every tile owns whole grid
+// words and workers never write to the same uint64_t.
+#define TILE_SIZE 256
+
+typedef struct {
+    Grid *maze;
+    int tilesX;
+    int tilesY;
+    Rng *streams;        // one jumped stream per tile
+    int next;            // next tile to carve, shared between workers
+} TiledJob;
+
+// Room bounds of tile (tx, ty). Tile borders fall on the even wall rows and
+// columns at multiples of TILE_SIZE, which stay closed until the join.
+static inline void TileBounds(const Grid *maze, int tx, int ty, int *x0, int *y0, int *x1, int *y1) {
+    *x0 = tx * TILE_SIZE + 1;
+    *y0 = ty * TILE_SIZE + 1;
+    *x1 = (tx + 1) * TILE_SIZE - 1;
+    *y1 = (ty + 1) * TILE_SIZE - 1;
+    if (*x1 > maze->N - 2) *x1 = maze->N - 2;
+    if (*y1 > maze->N - 2) *y1 = maze->N - 2;
+}
+
+static void *TiledWorker(void *arg) {
+    TiledJob *job = arg;
+    int total = job->tilesX * job->tilesY;
+    while (true) {
+        int t = __atomic_fetch_add(&job->next, 1, __ATOMIC_RELAXED);
+        if (t >= total) break;
+        int x0, y0, x1, y1;
+        TileBounds(job->maze, t % job->tilesX, t / job->tilesX, &x0, &y0, &x1, &y1);
+        GenerateMazeRegion(job->maze, x0, y0, x0, y0, x1, y1, &job->streams[t]);
+    }
+    return NULL;
+}
+
+// Open one random wall on the border between tile a and its right (or lower)
+// neighbour b.
+static void TiledJoin(Grid *maze, int tilesX, int a, int b, Rng *rng) {
+    int x0, y0, x1, y1;
+    TileBounds(maze, a % tilesX, a / tilesX, &x0, &y0, &x1, &y1);
+    if (b == a + 1) {
+        int y = y0 + 2 * (int)rng_below(rng, (y1 - y0) / 2 + 1);
+        grid_set(maze, x1 + 1, y, PATH);
+    } else {
+        int x = x0 + 2 * (int)rng_below(rng, (x1 - x0) / 2 + 1);
+        grid_set(maze, x, y1 + 1, PATH);
+    }
+}
+
+// Tiled parallel generator: every tile is carved as its own perfect maze on
+// a worker thread, then the tiles are joined along a random spanning tree of
+// the tile graph (one opening per tree edge), so the result is still a
+// perfect maze. Tile t carves with the (t+1)-th jumped stream of rng and
+// the join draws from rng itself on the calling thread, so the output is
+// bit-for-bit the same for any thread count. threads <= 0 uses every
+// online core.
+void GenerateMazeTiled(Grid *maze, Rng *rng, int threads) {
+    int tilesX = (maze->N - 3) / TILE_SIZE + 1;
+    int tilesY = tilesX;
+    int total = tilesX * tilesY;
+
+    TiledJob job = { .maze = maze, .tilesX = tilesX, .tilesY = tilesY, .next = 0 };
+    job.streams = malloc((size_t)total * sizeof(Rng));
+    rng_streams(rng, job.streams, total);
+
+    if (threads <= 0) threads = (int)sysconf(_SC_NPROCESSORS_ONLN);
+    if (threads > total) threads = total;
+    if (threads < 1) threads = 1;
+
+    pthread_t *workers = malloc((size_t)threads * sizeof(pthread_t));
+    int started = 0;
+    for (int i = 1; i < threads; i++) {
+        if (pthread_create(&workers[started], NULL, TiledWorker, &job) != 0) break;
+        started++;
+    }
+    TiledWorker(&job);
+    for (int i = 0; i < started; i++) pthread_join(workers[i], NULL);
+    free(workers);
+    free(job.streams);
+
+    // Random spanning tree over the tile graph (Kruskal on shuffled edges)
+    qol_list(int) edges = {0};
+    for (int t = 0; t < total; t++) {
+        if (t % tilesX + 1 < tilesX) qol_push(&edges, t, t + 1);
+        if (t / tilesX + 1 < tilesY) qol_push(&edges, t, t + tilesX);
+    }
+    int count = (int)edges.len / 2;
+    for (int i = count - 1; i > 0; i--) {
+        int r = (int)rng_below(rng, i + 1);
+        int a = edges.data[2 * i], b = edges.data[2 * i + 1];
+        edges.data[2 * i] = edges.data[2 * r];
+        edges.data[2 * i + 1] = edges.data[2 * r + 1];
+        edges.data[2 * r] = a;
+        edges.data[2 * r + 1] = b;
+    }
+
+    UnionFind uf;
+    uf_init(&uf, total);
+    for (int i = 0; i < count; i++) {
+        int a = edges.data[2 * i], b = edges.data[2 * i + 1];
+        if (uf_union(&uf, a, b)) TiledJoin(maze, tilesX, a, b, rng);
+    }
+    uf_free(&uf);
+    qol_release(&edges);
+}
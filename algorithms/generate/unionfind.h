@@ -0,0 +1,58 @@
+#pragma once
+#include "../../libs/build.h"
+
+// Disjoint-set forest over 0..n-1 with path halving and union by size.
+// Elements are 32-bit, so n can reach UINT32_MAX (a 131071-cell maze has
+// 65535^2 rooms) at 8 bytes per element.
+typedef struct {
+    uint32_t *parent;
+    uint32_t *size;
+    size_t n;
+} UnionFind;
+
+static inline void uf_init(UnionFind *uf, size_t n) {
+    if (n > UINT32_MAX) {
+        qol_error("Union-find of %zu elements is too large (max %u)\n", n, UINT32_MAX);
+        abort();
+    }
+    uf->n = n;
+    uf->parent = malloc(n * sizeof(uint32_t));
+    uf->size = malloc(n * sizeof(uint32_t));
+    if (n && (!uf->parent || !uf->size)) {
+        qol_error("Union-find out of memory (%zu elements)\n", n);
+        abort();
+    }
+    for (size_t i = 0; i < n; i++) {
+        uf->parent[i] = (uint32_t)i;
+        uf->size[i] = 1;
+    }
+}
+
+static inline void uf_free(UnionFind *uf) {
+    free(uf->parent);
+    free(uf->size);
+    uf->parent = uf->size = NULL;
+}
+
+static inline uint32_t uf_find(UnionFind *uf, uint32_t a) {
+    while (uf->parent[a] != a) {
+        uf->parent[a] = uf->parent[uf->parent[a]];
+        a = uf->parent[a];
+    }
+    return a;
+}
+
+// Returns false if a and b were already in the same set
+static inline bool uf_union(UnionFind *uf, uint32_t a, uint32_t b) {
+    a = uf_find(uf, a);
+    b = uf_find(uf, b);
+    if (a == b) return false;
+    if (uf->size[a] < uf->size[b]) {
+        uint32_t t = a;
+        a = b;
+        b = t;
+    }
+    uf->parent[b] = a;
+    uf->size[a] += uf->size[b];
+    return true;
+}
@@ -0,0 +1,51 @@
+#pragma once
+#include "../maze/grid.h"
+#include "../../rng.h"
+
+// Wilson's algorithm: loop-erased random walks from every room not yet in
+// the maze until they hit it. The walk only remembers the last direction
+// taken out of each room (one byte per room), which erases loops for free;
+// the walk is then replayed from its start along those directions and
+// carved. Produces a uniform spanning tree. Rooms already carved are the
+// ones that are PATH in the grid.
+void GenerateMazeWilson(Grid *maze, Rng *rng) {
+    int R = (maze->N - 1) / 2;
+    if (R <= 0) return;
+    size_t rooms = (size_t)R * (size_t)R;
+    uint8_t *out = malloc(rooms);
+
+    size_t root = (size_t)rng_below64(rng, rooms);
+    grid_set(maze, 2 * (int)(root % R) + 1, 2 * (int)(root / R) + 1, PATH);
+
+    for (size_t start = 0; start < rooms; start++) {
+        int sx = (int)(start % R), sy = (int)(start / R);
+        if (grid_get(maze, 2 * sx + 1, 2 * sy + 1) == PATH) continue;
+
+        // random walk until the maze is hit, recording the exit direction
+        int x = sx, y = sy;
+        while (grid_get(maze, 2 * x + 1, 2 * y + 1) == WALL) {
+            int d;
+            int nx, ny;
+            do {
+                d = (int)(rng_next(rng) >> 62);
+                nx = x + dirs[d][0];
+                ny = y + dirs[d][1];
+            } while (nx < 0 || nx >= R || ny < 0 || ny >= R);
+            out[(size_t)y * R + x] = (uint8_t)d;
+            x = nx;
+            y = ny;
+        }
+
+        // replay the loop-erased path and carve it
+        x = sx;
+        y = sy;
+        while (grid_get(maze, 2 * x + 1, 2 * y + 1) == WALL) {
+            int d = out[(size_t)y * R + x];
+            grid_set(maze, 2 * x + 1, 2 * y + 1, PATH);
+            grid_set(maze, 2 * x + 1 + dirs[d][0], 2 * y + 1 + dirs[d][1], PATH);
+            x += dirs[d][0];
+            y += dirs[d][1];
+        }
+    }
+    free(out);
+}
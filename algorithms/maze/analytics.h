@@ -0,0 +1,386 @@
+#pragma once
+#include "grid.h"
+
+// Structural statistics of a maze grid, used to pick a solver per maze.
+//
+// Degrees come from a bit-sliced adder over whole grid words: the four
+// neighbour planes of a 64-cell word are summed as 3-bit lane counters, so
+// one pass classifies 64 cells with a few dozen logic ops. Rows are split
+// into one band per thread, and each band also walks the corridors that
+// start in it. A corridor is a chain of degree-2 cells between two cells of
+// any other degree; its length is the number of moves between those ends
+// and it is counted from its smaller end. Rings made only of degree-2 cells
+// have no end and are not counted.
+//
+// The diameter is the double sweep: BFS from the first open cell to the
+// farthest cell b, then BFS from b. The depth of the second sweep is exact
+// on a tree (a perfect maze) and a lower bound otherwise. The sweeps run on
+// their own thread next to the bands. On a perfect maze they are a
+// depth-first walk (see analytics_tree_sweep()); otherwise they are
+// level-synchronous over a copy of the grid whose wall bits double as the
+// visited set; a level of at least ANALYTICS_PAR_LEVEL cells is split across
+// threads that claim cells with an atomic OR, and smaller levels are
+// expanded inline.
+#define ANALYTICS_BUCKETS 32
+#define ANALYTICS_PAR_LEVEL 65536
+
+typedef struct {
+    int N;
+    long open;
+    long edges;                            // adjacent pairs of open cells
+    long degree[5];                        // open cells by open-neighbour count
+    long corridors;
+    long corridorHist[ANALYTICS_BUCKETS];  // [k]: lengths in [2^k, 2^(k+1))
+    long corridorTotal;                    // sum of corridor lengths
+    long corridorMax;
+    long reached;                          // open cells in the swept component
+    int diameter;                          // in moves, -1 without open cells
+    int fromX, fromY, toX, toY;            // ends of the diameter
+    bool perfect;                          // connected and acyclic: diameter is exact
+} MazeStats;
+
+// BFS cells are packed as y << 16 | x, so N is limited to 65536
+typedef qol_list(uint32_t) AnalyticsList;
+
+// Degree planes of word w of row y: deg[k] has a bit set for each open cell
+// with exactly k open neighbours
+static inline void analytics_word(const Grid *g, int y, int w, uint64_t deg[5]) {
+    const uint64_t *row = grid_row(g, y);
+    uint64_t open = ~row[w];
+    uint64_t n = y > 0 ? ~grid_row(g, y - 1)[w] : 0;
+    uint64_t s = y + 1 < g->N ? ~grid_row(g, y + 1)[w] : 0;
+    uint64_t e = open >> 1 | (w + 1 < g->stride ? ~row[w + 1] << 63 : 0);
+    uint64_t west = open << 1 | (w > 0 ? ~row[w - 1] >> 63 : 0);
+
+    uint64_t s1 = n ^ s, c1 = n & s;
+    uint64_t s2 = e ^ west, c2 = e & west;
+    uint64_t lo = s1 ^ s2, c3 = s1 & s2;
+    uint64_t mid = c1 ^ c2 ^ c3;
+    uint64_t hi = (c1 & c2) | (c1 & c3) | (c2 & c3);
+    deg[0] = open & ~hi & ~mid & ~lo;
+    deg[1] = open & ~hi & ~mid & lo;
+    deg[2] = open & ~hi & mid & ~lo;
+    deg[3] = open & ~hi & mid & lo;
+    deg[4] = open & hi;
+}
+
+// Open neighbours of (x, y) as a mask, bit d for dirs[d]
+static inline unsigned analytics_mask(const Grid *g, int x, int y) {
+    unsigned m = 0;
+    if (y > 0 && grid_get(g, x, y - 1) == PATH) m |= 1;
+    if (x + 1 < g->N && grid_get(g, x + 1, y) == PATH) m |= 2;
+    if (y + 1 < g->N && grid_get(g, x, y + 1) == PATH) m |= 4;
+    if (x > 0 && grid_get(g, x - 1, y) == PATH) m |= 8;
+    return m;
+}
+
+// Follow the corridor leaving (x, y) in direction d to its other end.
+// Returns its length; *last is the direction of the final move.
+static long analytics_walk(const Grid *g, int x, int y, int d, int *ex, int *ey, int *last) {
+    int cx = x + dirs[d][0], cy = y + dirs[d][1];
+    long len = 1;
+    unsigned m;
+    while (__builtin_popcount(m = analytics_mask(g, cx, cy)) == 2) {
+        d = __builtin_ctz(m & ~(1u << ((d + 2) & 3)));
+        cx += dirs[d][0];
+        cy += dirs[d][1];
+        len++;
+    }
+    *ex = cx;
+    *ey = cy;
+    *last = d;
+    return len;
+}
+
+typedef struct {
+    const Grid *maze;
+    int y0, y1;
+    MazeStats part;
+} AnalyticsBand;
+
+static void *analytics_band(void *arg) {
+    AnalyticsBand *b = arg;
+    const Grid *g = b->maze;
+    MazeStats *p = &b->part;
+    for (int y = b->y0; y < b->y1; y++) {
+        for (int w = 0; w < g->stride; w++) {
+            uint64_t deg[5];
+            analytics_word(g, y, w, deg);
+            for (int k = 0; k < 5; k++) p->degree[k] += __builtin_popcountll(deg[k]);
+
+            for (uint64_t ends = deg[1] | deg[3] | deg[4]; ends; ends &= ends - 1) {
+                int x = w * 64 + __builtin_ctzll(ends);
+                for (unsigned m = analytics_mask(g, x, y); m; m &= m - 1) {
+                    int d = __builtin_ctz(m);
+                    int ex, ey, last;
+                    long len = analytics_walk(g, x, y, d, &ex, &ey, &last);
+                    long a = (long)y * g->N + x, c = (long)ey * g->N + ex;
+                    if (a > c || (a == c && d > ((last + 2) & 3))) continue;
+                    p->corridors++;
+                    p->corridorTotal += len;
+                    if (len > p->corridorMax) p->corridorMax = len;
+                    p->corridorHist[63 - __builtin_clzll((uint64_t)len)]++;
+                }
+            }
+        }
+    }
+    return NULL;
+}
+
+// Mark (x, y) reached if it is still open in seen; atomic when several
+// threads expand the same level
+static inline bool analytics_claim(Grid *seen, int x, int y, bool atomic) {
+    uint64_t *w = &grid_row(seen, y)[x >> 6];
+    uint64_t m = (uint64_t)1 << (x & 63);
+    if (!atomic) {
+        if (*w & m) return false;
+        *w |= m;
+        return true;
+    }
+    if (__atomic_load_n(w, __ATOMIC_RELAXED) & m) return false;
+    return !(__atomic_fetch_or(w, m, __ATOMIC_RELAXED) & m);
+}
+
+static void analytics_expand(Grid *seen, const uint32_t *cells, size_t from, size_t to, AnalyticsList *out, bool atomic) {
+    int N = seen->N;
+    for (size_t i = from; i < to; i++) {
+        uint32_t c = cells[i];
+        int x = (int)(c & 0xffff), y = (int)(c >> 16);
+        if (y > 0 && analytics_claim(seen, x, y - 1, atomic)) qol_push(out, c - 0x10000);
+        if (x + 1 < N && analytics_claim(seen, x + 1, y, atomic)) qol_push(out, c + 1);
+        if (y + 1 < N && analytics_claim(seen, x, y + 1, atomic)) qol_push(out, c + 0x10000);
+        if (x > 0 && analytics_claim(seen, x - 1, y, atomic)) qol_push(out, c - 1);
+    }
+}
+
+typedef struct {
+    Grid *seen;
+    const uint32_t *cells;
+    size_t from, to;
+    AnalyticsList out;
+} AnalyticsLevel;
+
+static void *analytics_level(void *arg) {
+    AnalyticsLevel *l = arg;
+    l->out.len = 0;
+    analytics_expand(l->seen, l->cells, l->from, l->to, &l->out, true);
+    return NULL;
+}
+
+// BFS from cell start; returns the depth of the deepest level, its smallest
+// cell in *far and the cells reached in *reached
+static int analytics_sweep(const Grid *maze, int threads, uint32_t start, uint32_t *far, long *reached) {
+    int N = maze->N;
+    Grid seen;
+    grid_init(&seen, N);
+    memcpy(seen.bits, maze->bits, (size_t)seen.stride * N * sizeof(uint64_t));
+    AnalyticsLevel *jobs = calloc((size_t)threads, sizeof(AnalyticsLevel));
+    pthread_t *workers = malloc((size_t)threads * sizeof(pthread_t));
+
+    AnalyticsList cur = {0}, next = {0};
+    analytics_claim(&seen, (int)(start & 0xffff), (int)(start >> 16), false);
+    qol_push(&cur, start);
+    int depth = 0;
+    *far = start;
+    *reached = 1;
+    while (true) {
+        next.len = 0;
+        if (threads > 1 && cur.len >= ANALYTICS_PAR_LEVEL) {
+            for (int t = 0; t < threads; t++) {
+                jobs[t].seen = &seen;
+                jobs[t].cells = cur.data;
+                jobs[t].from = cur.len * t / threads;
+                jobs[t].to = cur.len * (t + 1) / threads;
+            }
+            int started = 0;
+            for (int t = 1; t < threads; t++) {
+                if (pthread_create(&workers[started], NULL, analytics_level, &jobs[t]) != 0) {
+                    analytics_level(&jobs[t]);
+                    continue;
+                }
+                started++;
+            }
+            analytics_level(&jobs[0]);
+            for (int t = 0; t < started; t++) pthread_join(workers[t], NULL);
+            for (int t = 0; t < threads; t++) {
+                for (size_t i = 0; i < jobs[t].out.len; i++) qol_push(&next, jobs[t].out.data[i]);
+            }
+        } else {
+            analytics_expand(&seen, cur.data, 0, cur.len, &next, false);
+        }
+        if (next.len == 0) break;
+        depth++;
+        *reached += (long)next.len;
+        // Smallest cell of the level (packed cells sort like y * N + x), so
+        // the ends do not depend on which thread claimed what
+        *far = next.data[0];
+        for (size_t i = 1; i < next.len; i++) {
+            if (next.data[i] < *far) *far = next.data[i];
+        }
+        AnalyticsList t = cur;
+        cur = next;
+        next = t;
+    }
+
+    for (int t = 0; t < threads; t++) qol_release(&jobs[t].out);
+    free(jobs);
+    free(workers);
+    qol_release(&cur);
+    qol_release(&next);
+    grid_free(&seen);
+    return depth;
+}
+
+// Depth-first sweep from cell start, valid only when the maze is a tree:
+// there the depth of a cell along any walk from start is its distance, so a
+// stack that follows corridors (and stays in cache) replaces the BFS levels.
+// Same results as analytics_sweep() on a tree.
+static int analytics_tree_sweep(const Grid *maze, uint32_t start, uint32_t *far, long *reached) {
+    int N = maze->N;
+    Grid seen;
+    grid_init(&seen, N);
+    memcpy(seen.bits, maze->bits, (size_t)seen.stride * N * sizeof(uint64_t));
+    qol_list(uint64_t) stack = {0};  // depth << 32 | packed cell
+
+    analytics_claim(&seen, (int)(start & 0xffff), (int)(start >> 16), false);
+    qol_push(&stack, (uint64_t)start);
+    int best = 0;
+    *far = start;
+    *reached = 0;
+    while (stack.len > 0) {
+        uint64_t e = stack.data[--stack.len];
+        uint32_t c = (uint32_t)e;
+        int depth = (int)(e >> 32);
+        int x = (int)(c & 0xffff), y = (int)(c >> 16);
+        (*reached)++;
+        if (depth > best || (depth == best && c < *far)) {
+            best = depth;
+            *far = c;
+        }
+        uint64_t next = (uint64_t)(depth + 1) << 32;
+        if (y > 0 && analytics_claim(&seen, x, y - 1, false)) qol_push(&stack, next | (c - 0x10000));
+        if (x + 1 < N && analytics_claim(&seen, x + 1, y, false)) qol_push(&stack, next | (c + 1));
+        if (y + 1 < N && analytics_claim(&seen, x, y + 1, false)) qol_push(&stack, next | (c + 0x10000));
+        if (x > 0 && analytics_claim(&seen, x - 1, y, false)) qol_push(&stack, next | (c - 1));
+    }
+    qol_release(&stack);
+    grid_free(&seen);
+    return best;
+}
+
+typedef struct {
+    const Grid *maze;
+    int threads;
+    MazeStats *stats;
+} AnalyticsDiameter;
+
+static void *analytics_diameter(void *arg) {
+    AnalyticsDiameter *job = arg;
+    const Grid *g = job->maze;
+    MazeStats *st = job->stats;
+    st->diameter = -1;
+    bool found = false;
+    uint32_t start = 0;
+    for (int y = 0; y < g->N && !found; y++) {
+        const uint64_t *row = grid_row(g, y);
+        for (int w = 0; w < g->stride; w++) {
+            if (~row[w]) {
+                start = (uint32_t)y << 16 | (uint32_t)(w * 64 + __builtin_ctzll(~row[w]));
+                found = true;
+                break;
+            }
+        }
+    }
+    if (!found) return NULL;
+
+    // A connected maze with open - 1 edges is a tree. The edge count is a
+    // quick word pass; connectivity is known once the first sweep is done.
+    long open = 0, degreeSum = 0;
+    for (int y = 0; y < g->N; y++) {
+        for (int w = 0; w < g->stride; w++) {
+            uint64_t deg[5];
+            analytics_word(g, y, w, deg);
+            for (int k = 1; k < 5; k++) degreeSum += k * __builtin_popcountll(deg[k]);
+            open += __builtin_popcountll(deg[0] | deg[1] | deg[2] | deg[3] | deg[4]);
+        }
+    }
+    uint32_t b, c;
+    long reached = 0;
+    bool tree = degreeSum / 2 == open - 1;
+    if (tree) {
+        analytics_tree_sweep(g, start, &b, &reached);
+        tree = reached == open;
+    }
+    if (tree) {
+        st->diameter = analytics_tree_sweep(g, b, &c, &reached);
+    } else {
+        analytics_sweep(g, job->threads, start, &b, &reached);
+        st->diameter = analytics_sweep(g, job->threads, b, &c, &reached);
+    }
+    st->reached = reached;
+    st->fromX = (int)(b & 0xffff);
+    st->fromY = (int)(b >> 16);
+    st->toX = (int)(c & 0xffff);
+    st->toY = (int)(c >> 16);
+    return NULL;
+}
+
+// Compute every statistic of maze. threads <= 0 uses every online core; the
+// result does not depend on the thread count.
+static void analytics_run(MazeStats *st, const Grid *maze, int threads) {
+    int N = maze->N;
+    memset(st, 0, sizeof(*st));
+    st->N = N;
+    st->diameter = -1;
+    if (N > 65536) {
+        qol_error("Maze analytics supports N up to 65536 (got %d)\n", N);
+        return;
+    }
+    if (threads <= 0) threads = (int)sysconf(_SC_NPROCESSORS_ONLN);
+    if (threads > N) threads = N;
+    if (threads < 1) threads = 1;
+
+    // With a single thread the sweeps would only evict the bands' rows from
+    // the cache, so they run after the bands instead of next to them
+    AnalyticsDiameter diam = { maze, threads, st };
+    pthread_t sweeper;
+    bool sweeping = threads > 1 && pthread_create(&sweeper, NULL, analytics_diameter, &diam) == 0;
+
+    AnalyticsBand *bands = calloc((size_t)threads, sizeof(AnalyticsBand));
+    pthread_t *workers = malloc((size_t)threads * sizeof(pthread_t));
+    for (int t = 0; t < threads; t++) {
+        bands[t].maze = maze;
+        bands[t].y0 = (int)((long)N * t / threads);
+        bands[t].y1 = (int)((long)N * (t + 1) / threads);
+    }
+    int started = 0;
+    for (int t = 1; t < threads; t++) {
+        if (pthread_create(&workers[started], NULL, analytics_band, &bands[t]) != 0) {
+            analytics_band(&bands[t]);
+            continue;
+        }
+        started++;
+    }
+    analytics_band(&bands[0]);
+    for (int t = 0; t < started; t++) pthread_join(workers[t], NULL);
+    if (sweeping) pthread_join(sweeper, NULL);
+    else analytics_diameter(&diam);
+
+    long degreeSum = 0;
+    for (int t = 0; t < threads; t++) {
+        const MazeStats *p = &bands[t].part;
+        for (int k = 0; k < 5; k++) st->degree[k] += p->degree[k];
+        st->corridors += p->corridors;
+        st->corridorTotal += p->corridorTotal;
+        if (p->corridorMax > st->corridorMax) st->corridorMax = p->corridorMax;
+        for (int k = 0; k < ANALYTICS_BUCKETS; k++) st->corridorHist[k] += p->corridorHist[k];
+    }
+    for (int k = 0; k < 5; k++) {
+        st->open += st->degree[k];
+        degreeSum += k * st->degree[k];
+    }
+    st->edges = degreeSum / 2;
+    st->perfect = st->open > 0 && st->reached == st->open && st->edges == st->open - 1;
+    free(workers);
+    free(bands);
+}
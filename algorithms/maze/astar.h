@@ -1,28 +1,32 @@
 #pragma once
 #include "common.h"
+#include "pqueue.h"
 
 #define ALGO_NAME "A*"
 
-// A* step
+// Manhattan distance to the goal times the cheapest cell cost
+static inline int astar_h(const SearchState *s, int i) {
+    return (abs(search_x(s, i) - s->goalX) + abs(search_y(s, i) - s->goalY)) * search_min_cost(s);
+}
+
+// A* step over the queue picked with search_set_queue() (see pqueue.h),
+// keyed on f = g + h; the binary heap breaks ties to the larger g. Every
+// move costs at least the cheapest cell, so Manhattan distance scaled by it
+// never overestimates and paths stay optimal; it is also consistent, so a
+// settled cell is never improved again.
 static inline bool step(SearchState *s) {
-    int bestIdx = -1;
-    int bestScore = INF;
-    for (int i = 0; i < s->max; i++) {
-        if (s->visited[i] && !s->processed[i]) {
-            int cx = i % s->N;
-            int cy = i / s->N;
-            int h = abs(cx - s->goalX) + abs(cy - s->goalY);
-            int score = s->dist[i] + h;
-            if (score < bestScore) {
-                bestScore = score;
-                bestIdx = i;
-            }
-        }
+    if (s->unreachable) return false;
+    int startIdx = search_index(s, s->startX, s->startY);
+    if (!s->processed[startIdx] && s->fscore[startIdx] == INF) {
+        s->fscore[startIdx] = astar_h(s, startIdx);
+        search_queue_push(s, startIdx);
     }
+
+    int bestIdx = search_queue_pop(s);
     if (bestIdx == -1) return false;
 
-    int x = bestIdx % s->N;
-    int y = bestIdx / s->N;
+    int x = search_x(s, bestIdx);
+    int y = search_y(s, bestIdx);
     s->processed[bestIdx] = 1;
 
     if (x == s->goalX && y == s->goalY) {
@@ -30,17 +34,16 @@ static inline bool step(SearchState *s) {
         return true;
     }
 
-    for (int i = 0; i < 4; i++) {
-        int nx = x + dirs[i][0];
-        int ny = y + dirs[i][1];
-        if (nx >= 0 && nx < s->N && ny >= 0 && ny < s->N && s->maze[ny][nx] == PATH) {
-            int idx = ny * s->N + nx;
-            int nd = s->dist[y * s->N + x] + 1;
-            if (nd < s->dist[idx]) {
-                s->dist[idx] = nd;
-                s->parent[idx] = y * s->N + x;
-                s->visited[idx] = 1;
-            }
+    for (unsigned m = search_neighbors(s, bestIdx); m; m &= m - 1) {
+        int idx = search_move(s, bestIdx, __builtin_ctz(m));
+        if (s->processed[idx]) continue;
+        int nd = s->dist[bestIdx] + search_cost(s, idx);
+        if (nd < s->dist[idx]) {
+            s->dist[idx] = nd;
+            s->fscore[idx] = nd + astar_h(s, idx);
+            s->parent[idx] = bestIdx;
+            s->visited[idx] = 1;
+            search_queue_push(s, idx);
         }
     }
     return false;
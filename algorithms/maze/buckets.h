@@ -0,0 +1,63 @@
+#pragma once
+#include "../../libs/build.h"
+
+// Bucket queue for small integer keys in [0, keys): one LIFO list per key,
+// linked through a per-slot next array, and a cursor at the lowest bucket
+// that may be non-empty. Push and pop are O(1) apart from moving the
+// cursor up past empty buckets; a push below the cursor moves it down.
+// Slots are search slots, each in the queue at most once.
+typedef struct {
+    int keys;
+    int *head;       // per key, first slot of its list or -1
+    int *next;       // per slot, next slot in the same list or -1
+    int min;         // no bucket below min is non-empty
+    int len;
+} BucketQueue;
+
+static inline void bucket_queue_init(BucketQueue *q, int keys, int slots) {
+    q->keys = keys;
+    q->head = malloc((size_t)keys * sizeof(int));
+    q->next = malloc((size_t)slots * sizeof(int));
+    if (!q->head || !q->next) {
+        qol_error("Bucket queue out of memory (%d keys, %d slots)\n", keys, slots);
+        abort();
+    }
+    for (int k = 0; k < keys; k++) q->head[k] = -1;
+    q->min = keys;
+    q->len = 0;
+}
+
+static inline void bucket_queue_free(BucketQueue *q) {
+    free(q->head);
+    free(q->next);
+    q->head = NULL;
+    q->next = NULL;
+}
+
+// Make room for slots [0, slots) after the search gained slots
+static inline void bucket_queue_grow(BucketQueue *q, int slots) {
+    int *next = realloc(q->next, (size_t)slots * sizeof(int));
+    if (!next) {
+        qol_error("Bucket queue out of memory (%d slots)\n", slots);
+        abort();
+    }
+    q->next = next;
+}
+
+static inline void bucket_queue_push(BucketQueue *q, int slot, int key) {
+    q->next[slot] = q->head[key];
+    q->head[key] = slot;
+    if (key < q->min) q->min = key;
+    q->len++;
+}
+
+// Remove and return the most recently pushed slot of the lowest key, -1
+// when empty
+static inline int bucket_queue_pop(BucketQueue *q) {
+    if (q->len == 0) return -1;
+    while (q->head[q->min] < 0) q->min++;
+    int slot = q->head[q->min];
+    q->head[q->min] = q->next[slot];
+    q->len--;
+    return slot;
+}
@@ -0,0 +1,103 @@
+#pragma once
+#include "../../libs/build.h"
+
+// Dense ids for the cells a sparse search touches, in order of first touch:
+// an open-addressing hash table from cell (x, y) to id, plus the cell of
+// every id. Both grow by doubling (the table at half load), so memory
+// follows the number of cells seen, not the extent of the coordinates.
+typedef struct {
+    uint64_t *keys;  // per bucket, cell key + 1, 0 when empty
+    int *ids;        // per bucket
+    int mask;        // buckets - 1
+    int *xs, *ys;    // per id
+    int count;
+    int cap;         // ids with room in xs / ys
+} CellMap;
+
+static inline uint64_t cell_map_key(int x, int y) {
+    return ((uint64_t)(uint32_t)y << 32 | (uint32_t)x) + 1;
+}
+
+static inline int cell_map_bucket(const CellMap *m, uint64_t key) {
+    key *= 0x9e3779b97f4a7c15ULL;
+    return (int)((key ^ key >> 29) & (uint64_t)m->mask);
+}
+
+static inline void cell_map_init(CellMap *m, int cap) {
+    int buckets = 1;
+    while (buckets < 2 * cap) buckets <<= 1;
+    m->keys = calloc((size_t)buckets, sizeof(uint64_t));
+    m->ids = malloc((size_t)buckets * sizeof(int));
+    m->xs = malloc((size_t)cap * sizeof(int));
+    m->ys = malloc((size_t)cap * sizeof(int));
+    if (!m->keys || !m->ids || !m->xs || !m->ys) {
+        qol_error("Cell map out of memory (%d cells)\n", cap);
+        abort();
+    }
+    m->mask = buckets - 1;
+    m->count = 0;
+    m->cap = cap;
+}
+
+static inline void cell_map_free(CellMap *m) {
+    free(m->keys);
+    free(m->ids);
+    free(m->xs);
+    free(m->ys);
+    m->keys = NULL;
+}
+
+static inline size_t cell_map_bytes(const CellMap *m) {
+    return (size_t)(m->mask + 1) * (sizeof(uint64_t) + sizeof(int)) + (size_t)m->cap * 2 * sizeof(int);
+}
+
+static void cell_map_grow(CellMap *m) {
+    int cap = 2 * m->cap;
+    int *xs = realloc(m->xs, (size_t)cap * sizeof(int));
+    int *ys = realloc(m->ys, (size_t)cap * sizeof(int));
+    int buckets = 2 * (m->mask + 1);
+    uint64_t *keys = calloc((size_t)buckets, sizeof(uint64_t));
+    int *ids = malloc((size_t)buckets * sizeof(int));
+    if (!xs || !ys || !keys || !ids) {
+        qol_error("Cell map out of memory (%d cells)\n", cap);
+        abort();
+    }
+    uint64_t *oldKeys = m->keys;
+    int *oldIds = m->ids;
+    int oldBuckets = m->mask + 1;
+    m->xs = xs;
+    m->ys = ys;
+    m->cap = cap;
+    m->keys = keys;
+    m->ids = ids;
+    m->mask = buckets - 1;
+    for (int b = 0; b < oldBuckets; b++) {
+        if (!oldKeys[b]) continue;
+        int i = cell_map_bucket(m, oldKeys[b]);
+        while (m->keys[i]) i = (i + 1) & m->mask;
+        m->keys[i] = oldKeys[b];
+        m->ids[i] = oldIds[b];
+    }
+    free(oldKeys);
+    free(oldIds);
+}
+
+// Id of cell (x, y), handing out the next one on first touch
+static inline int cell_map_id(CellMap *m, int x, int y) {
+    uint64_t key = cell_map_key(x, y);
+    int i = cell_map_bucket(m, key);
+    while (m->keys[i]) {
+        if (m->keys[i] == key) return m->ids[i];
+        i = (i + 1) & m->mask;
+    }
+    if (m->count == m->cap) {
+        cell_map_grow(m);
+        return cell_map_id(m, x, y);
+    }
+    int id = m->count++;
+    m->keys[i] = key;
+    m->ids[i] = id;
+    m->xs[id] = x;
+    m->ys[id] = y;
+    return id;
+}
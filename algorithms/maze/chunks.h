@@ -0,0 +1,164 @@
+#pragma once
+#include "grid.h"
+#include "../generate/backtracker.h"
+#include "../../rng.h"
+
+// Unbounded maze made of CHUNK_SIZE x CHUNK_SIZE chunks that are generated
+// on first touch from (seed, chunk x, chunk y) and kept in a fixed-size LRU
+// cache, so an evicted chunk comes back bit-for-bit the same.
+//
+// World cells use the usual parity: rooms at odd (x, y), walls between. A
+// chunk owns local column 0 and row 0, which are the walls it shares with
+// its west and north neighbours, and carves its 32 x 32 rooms as a perfect
+// maze. It then opens one random cell in each of those two border walls.
+// Every border wall has exactly one owner, so neighbours always agree on it
+// and no chunk ever reads another. Joining each chunk to both its west and
+// north neighbour keeps any chunk-aligned rectangle connected; the price is
+// loops at chunk scale, so the world is not a perfect maze.
+#define CHUNK_BITS 6
+#define CHUNK_SIZE (1 << CHUNK_BITS)   // one chunk row is one uint64_t
+#define CHUNK_MASK (CHUNK_SIZE - 1)
+
+typedef struct {
+    int cx, cy;
+    int prev, next;   // LRU list, most recent first
+    int chain;        // next slot in the same hash bucket
+    uint64_t rows[CHUNK_SIZE];
+} Chunk;
+
+typedef struct {
+    uint64_t seed;
+    int capacity;
+    int count;
+    Chunk *slots;
+    int *buckets;     // first slot per bucket, -1 when empty
+    int bucketMask;
+    int head, tail;   // most / least recently used slot
+    int last;         // slot of the previous lookup, checked first
+    long hits, misses;
+} ChunkSource;
+
+static inline void chunk_source_init(ChunkSource *src, uint64_t seed, int capacity) {
+    if (capacity < 1) capacity = 1;
+    int buckets = 1;
+    while (buckets < 2 * capacity) buckets <<= 1;
+    src->seed = seed;
+    src->capacity = capacity;
+    src->count = 0;
+    src->slots = malloc((size_t)capacity * sizeof(Chunk));
+    src->buckets = malloc((size_t)buckets * sizeof(int));
+    if (!src->slots || !src->buckets) {
+        qol_error("Chunk cache out of memory (%d chunks)\n", capacity);
+        abort();
+    }
+    for (int i = 0; i < buckets; i++) src->buckets[i] = -1;
+    src->bucketMask = buckets - 1;
+    src->head = src->tail = -1;
+    src->last = -1;
+    src->hits = src->misses = 0;
+}
+
+static inline void chunk_source_free(ChunkSource *src) {
+    free(src->slots);
+    free(src->buckets);
+    src->slots = NULL;
+    src->buckets = NULL;
+}
+
+static inline size_t chunk_source_bytes(const ChunkSource *src) {
+    return (size_t)src->capacity * sizeof(Chunk) + (size_t)(src->bucketMask + 1) * sizeof(int);
+}
+
+static inline int chunk_bucket(const ChunkSource *src, int cx, int cy) {
+    uint32_t h = (uint32_t)cx * 0x9e3779b1u ^ (uint32_t)cy * 0x85ebca77u;
+    return (int)((h ^ (h >> 15)) & (uint32_t)src->bucketMask);
+}
+
+// Per-chunk seed: the world seed and both chunk coordinates mixed so that
+// nearby chunks get unrelated streams
+static inline uint64_t chunk_seed(uint64_t seed, int cx, int cy) {
+    uint64_t z = seed ^ ((uint64_t)(uint32_t)cx << 32 | (uint32_t)cy);
+    z = (z ^ (z >> 33)) * 0xff51afd7ed558ccdULL;
+    z = (z ^ (z >> 33)) * 0xc4ceb9fe1a85ec53ULL;
+    return z ^ (z >> 33);
+}
+
+static void chunk_generate(Chunk *c, uint64_t seed) {
+    Rng rng;
+    rng_seed(&rng, chunk_seed(seed, c->cx, c->cy));
+    Grid g = { .N = CHUNK_SIZE, .stride = 1, .bits = c->rows };
+    grid_clear(&g);
+    GenerateMazeRegion(&g, 1, 1, 1, 1, CHUNK_SIZE - 1, CHUNK_SIZE - 1, &rng);
+    grid_set(&g, 0, 1 + 2 * (int)rng_below(&rng, CHUNK_SIZE / 2), PATH);
+    grid_set(&g, 1 + 2 * (int)rng_below(&rng, CHUNK_SIZE / 2), 0, PATH);
+}
+
+static inline void chunk_lru_unlink(ChunkSource *src, int i) {
+    Chunk *c = &src->slots[i];
+    if (c->prev >= 0) src->slots[c->prev].next = c->next;
+    else src->head = c->next;
+    if (c->next >= 0) src->slots[c->next].prev = c->prev;
+    else src->tail = c->prev;
+}
+
+static inline void chunk_lru_push_front(ChunkSource *src, int i) {
+    Chunk *c = &src->slots[i];
+    c->prev = -1;
+    c->next = src->head;
+    if (src->head >= 0) src->slots[src->head].prev = i;
+    src->head = i;
+    if (src->tail < 0) src->tail = i;
+}
+
+static void chunk_unhash(ChunkSource *src, int i) {
+    int *link = &src->buckets[chunk_bucket(src, src->slots[i].cx, src->slots[i].cy)];
+    while (*link != i) link = &src->slots[*link].chain;
+    *link = src->slots[i].chain;
+}
+
+// Chunk (cx, cy), generating it (and evicting the least recently used one
+// when the cache is full) if it is not resident
+static const Chunk *chunk_lookup(ChunkSource *src, int cx, int cy) {
+    if (src->last >= 0 && src->slots[src->last].cx == cx && src->slots[src->last].cy == cy) {
+        src->hits++;
+        return &src->slots[src->last];
+    }
+
+    int b = chunk_bucket(src, cx, cy);
+    for (int i = src->buckets[b]; i >= 0; i = src->slots[i].chain) {
+        if (src->slots[i].cx == cx && src->slots[i].cy == cy) {
+            src->hits++;
+            if (src->head != i) {
+                chunk_lru_unlink(src, i);
+                chunk_lru_push_front(src, i);
+            }
+            src->last = i;
+            return &src->slots[i];
+        }
+    }
+
+    src->misses++;
+    int i;
+    if (src->count < src->capacity) {
+        i = src->count++;
+    } else {
+        i = src->tail;
+        chunk_lru_unlink(src, i);
+        chunk_unhash(src, i);
+    }
+    Chunk *c = &src->slots[i];
+    c->cx = cx;
+    c->cy = cy;
+    chunk_generate(c, src->seed);
+    c->chain = src->buckets[b];
+    src->buckets[b] = i;
+    chunk_lru_push_front(src, i);
+    src->last = i;
+    return c;
+}
+
+// Cell at world (x, y); WALL or PATH. Any int coordinate is valid.
+static inline int chunk_get(ChunkSource *src, int x, int y) {
+    const Chunk *c = chunk_lookup(src, x >> CHUNK_BITS, y >> CHUNK_BITS);
+    return (int)((c->rows[y & CHUNK_MASK] >> (x & CHUNK_MASK)) & 1);
+}
@@ -1,5 +1,17 @@
 #pragma once
 #include "../../libs/build.h"
+#include "grid.h"
+#include "chunks.h"
+#include "costs.h"
+#include "components.h"
+#include "neighbors.h"
+#include "buckets.h"
+#include "dial.h"
+#include "radix.h"
+#include "pairing.h"
+#include "lazyheap.h"
+#include "cellmap.h"
+#include "../../rng.h"
 
 typedef struct {
     int x;
@@ -8,37 +20,216 @@ typedef struct {
 
 typedef qol_list(Cell) CellList;
 
+// Open set of Dijkstra and A*, chosen per search with search_set_queue()
+// (see pqueue.h)
+typedef enum {
+    QUEUE_BINARY,    // indexed binary heap with decrease-key
+    QUEUE_QUAD,      // indexed 4-ary heap
+    QUEUE_OCT,       // indexed 8-ary heap
+    QUEUE_PAIRING,   // pairing heap, O(1) decrease-key
+    QUEUE_LAZY,      // binary heap without positions, lazy deletion
+    QUEUE_DIAL,      // Dial's ring of buckets, integer keys
+    QUEUE_RADIX,     // radix heap, integer keys, lazy deletion
+    QUEUE_COUNT,
+} SearchQueue;
+
+static const char *QUEUE_NAMES[QUEUE_COUNT] = {
+    [QUEUE_BINARY]  = "binary",
+    [QUEUE_QUAD]    = "4-ary",
+    [QUEUE_OCT]     = "8-ary",
+    [QUEUE_PAIRING] = "pairing",
+    [QUEUE_LAZY]    = "lazy",
+    [QUEUE_DIAL]    = "dial",
+    [QUEUE_RADIX]   = "radix",
+};
+
+// One queue operation as seen by the stepper, recorded when a search has a
+// trace (search_set_trace) for replay against every queue. A push of a
+// slot that is still queued is a decrease-key; a pop records the slot and
+// key that came out.
+typedef enum {
+    QUEUE_OP_PUSH,
+    QUEUE_OP_POP,
+} QueueOpKind;
+
+typedef struct {
+    QueueOpKind op;
+    int slot;
+    int key;         // fscore
+    int g;           // dist, the binary heaps' tie-break
+} QueueOp;
+
+typedef qol_list(QueueOp) QueueTrace;
+
 typedef struct {
     int N;
-    int **maze;
+    const Grid *maze;
+    // When set, cells come from this unbounded source instead of maze and the
+    // search runs over the N x N window whose top-left is world (originX,
+    // originY). Such a search is sparse: slots are handed out by cells on
+    // first touch and every per-slot array grows with them.
+    ChunkSource *chunks;
+    int originX, originY;
+    CellMap cells;
+    // Optional cost of entering each cell (Dijkstra and A*); NULL means 1
+    const CostGrid *costs;
     int startX, startY, goalX, goalY;
+    int dirs[4][2];  // neighbour order for this search, drawn from the run's Rng
+    int order[4];    // s->dirs[k] is dirs[order[k]]
+    int offset[4];   // the same moves as index offsets (LAYOUT_ROW only)
+    // Optional precomputed open-direction masks of maze; remap turns a mask
+    // (bit d = dirs[d]) into one in this search's order (bit i = s->dirs[i])
+    const NeighborMasks *masks;
+    uint8_t remap[16];
 
-    int max;
+    // Every per-cell array below is numbered by the cell layout of layout.h
+    // (or by cells for a sparse search), see search_index()
+    int layout;      // LAYOUT_ROW or LAYOUT_MORTON
+    int shift;
+    int stride;
+    int max;         // slots per array, padding included
     int *visited;
     int *parent;
     int *dist;
     int *processed;
     int *fscore;     // used by A* variants
 
-    // Min-heap for priority-based searches (indexes into grid)
+    // Min-heap for priority-based searches (search indexes)
     int *heap;
     int *heap_pos;
     int heap_len;
 
+    // Bucket queue for searches keyed on small integers (greedy), allocated
+    // by the stepper on its first step
+    BucketQueue buckets;
+
+    // Priority queue of Dijkstra and A* over fscore; the d-ary heaps use
+    // heap / heap_pos above, the others are allocated on their first push
+    SearchQueue queueKind;
+    DialQueue dial;
+    RadixHeap radix;
+    PairingHeap pairing;
+    LazyHeap lazy;
+    long pushes, pops;  // queue operations so far, stale copies included
+    QueueTrace *trace;  // appended to by every push and pop when set
+
     CellList queue; // used by BFS/DFS and for discovered nodes
     int head;       // BFS head index
 
     CellList path;  // filled when goal found
+    bool unreachable; // start and goal are in different components, step() does nothing
 } SearchState;
 
-static inline void search_init(SearchState *s, int N, int **maze, int sx, int sy, int gx, int gy) {
+// Double the per-slot arrays of a sparse search, queues included; new slots
+// start unvisited, without parent and unreached
+static void search_grow(SearchState *s) {
+    int old = s->max;
+    int max = 2 * old;
+    int **arrays[] = { &s->visited, &s->parent, &s->dist, &s->processed, &s->fscore, &s->heap, &s->heap_pos };
+    const int fill[] = { 0, -1, INF, 0, INF, 0, -1 };
+    for (int k = 0; k < (int)QOL_ARRAY_LEN(arrays); k++) {
+        int *a = realloc(*arrays[k], (size_t)max * sizeof(int));
+        if (!a) {
+            qol_error("Search state out of memory (%d cells)\n", max);
+            abort();
+        }
+        for (int i = old; i < max; i++) a[i] = fill[k];
+        *arrays[k] = a;
+    }
+    if (s->buckets.head) bucket_queue_grow(&s->buckets, max);
+    if (s->dial.head) dial_grow(&s->dial, old, max);
+    if (s->pairing.key) pairing_grow(&s->pairing, old, max);
+    s->max = max;
+}
+
+static inline int search_index(SearchState *s, int x, int y) {
+    if (s->chunks) {
+        int id = cell_map_id(&s->cells, x, y);
+        if (id >= s->max) search_grow(s);
+        return id;
+    }
+    return layout_index(s->layout, s->shift, x, y);
+}
+
+static inline int search_x(const SearchState *s, int i) {
+    return s->chunks ? s->cells.xs[i] : layout_x(s->layout, s->shift, i);
+}
+
+static inline int search_y(const SearchState *s, int i) {
+    return s->chunks ? s->cells.ys[i] : layout_y(s->layout, s->shift, i);
+}
+
+// Slot reached from slot i by the move s->dirs[k]
+static inline int search_move(SearchState *s, int i, int k) {
+    if (s->chunks) return search_index(s, s->cells.xs[i] + s->dirs[k][0], s->cells.ys[i] + s->dirs[k][1]);
+    if (s->layout == LAYOUT_MORTON) return layout_move(s->layout, s->shift, i, s->order[k]);
+    return i + s->offset[k];
+}
+
+// Most cells a search can settle: every slot of a dense search, every
+// window cell of a sparse one
+static inline long search_cell_bound(const SearchState *s) {
+    return s->chunks ? (long)s->N * s->N : s->max;
+}
+
+// Start slots sparse searches with
+#define SEARCH_SPARSE_SLOTS 4096
+
+// Whether a dense search over an N x N maze can index its slots in the
+// given layout (see the padding note in layout.h); logs an error when not
+static inline bool search_layout_ok(int layout, int N) {
+    if (layout_fits(layout, N)) return true;
+    qol_error("Cannot search a %d x %d maze: %zu slots under the %s layout overflow an int index\n",
+              N, N, layout_cells(layout, N), LAYOUT_NAMES[layout]);
+    return false;
+}
+
+// search_layout_ok() for the default layout. Commands taking N from the
+// user check this before building anything.
+static inline bool search_size_ok(int N) {
+    return search_layout_ok(SEARCH_LAYOUT, N);
+}
+
+static inline void search_begin(SearchState *s, int layout, int N, const Grid *maze, ChunkSource *chunks, int sx, int sy, int gx, int gy, Rng *rng) {
     s->N = N;
     s->maze = maze;
+    s->chunks = chunks;
+    s->originX = 0;
+    s->originY = 0;
+    s->cells = (CellMap){0};
+    s->costs = NULL;
+    s->masks = NULL;
+    s->unreachable = false;
     s->startX = sx;
     s->startY = sy;
     s->goalX = gx;
     s->goalY = gy;
-    s->max = N * N;
+    if (!chunks && !search_layout_ok(layout, N)) abort();
+    s->layout = layout;
+    s->shift = chunks ? 0 : layout_shift(layout, N);
+    s->stride = 1 << s->shift;
+    s->max = chunks ? SEARCH_SPARSE_SLOTS : (int)layout_cells(layout, N);
+    if (chunks) cell_map_init(&s->cells, SEARCH_SPARSE_SLOTS);
+
+    int order[4] = {0, 1, 2, 3};
+    for (int i = 3; i > 0; i--) {
+        int r = (int)rng_below(rng, i + 1);
+        int t = order[i];
+        order[i] = order[r];
+        order[r] = t;
+    }
+    for (int i = 0; i < 4; i++) {
+        s->dirs[i][0] = dirs[order[i]][0];
+        s->dirs[i][1] = dirs[order[i]][1];
+        s->order[i] = order[i];
+        s->offset[i] = s->dirs[i][1] * s->stride + s->dirs[i][0];
+    }
+    for (int m = 0; m < 16; m++) {
+        s->remap[m] = 0;
+        for (int i = 0; i < 4; i++) {
+            if (m & (1 << order[i])) s->remap[m] |= (uint8_t)(1 << i);
+        }
+    }
 
     s->visited = calloc(s->max, sizeof(int));
     s->parent = malloc(s->max * sizeof(int));
@@ -54,6 +245,15 @@ static inline void search_init(SearchState *s, int N, int **maze, int sx, int sy
         s->heap_pos[i] = -1;
     }
     s->heap_len = 0;
+    s->buckets = (BucketQueue){0};
+    s->queueKind = QUEUE_BINARY;
+    s->dial = (DialQueue){0};
+    s->radix = (RadixHeap){0};
+    s->pairing = (PairingHeap){0};
+    s->lazy = (LazyHeap){0};
+    s->pushes = 0;
+    s->pops = 0;
+    s->trace = NULL;
 
     s->queue.len = s->queue.cap = 0;
     s->queue.data = NULL;
@@ -62,8 +262,117 @@ static inline void search_init(SearchState *s, int N, int **maze, int sx, int sy
 
     qol_push(&s->queue, ((Cell){sx, sy}));
     s->head = 0;
-    s->visited[sy * N + sx] = 1;
-    s->dist[sy * N + sx] = 0;
+    int start = search_index(s, sx, sy); // may grow a sparse search's arrays
+    s->visited[start] = 1;
+    s->dist[start] = 0;
+}
+
+static inline void search_init(SearchState *s, int N, const Grid *maze, int sx, int sy, int gx, int gy, Rng *rng) {
+    search_begin(s, SEARCH_LAYOUT, N, maze, NULL, sx, sy, gx, gy, rng);
+}
+
+// search_init() numbering the per-cell arrays in the given layout instead of
+// SEARCH_LAYOUT; neighbour masks passed to it must use the same one
+static inline void search_init_layout(SearchState *s, int layout, int N, const Grid *maze, int sx, int sy, int gx, int gy, Rng *rng) {
+    search_begin(s, layout, N, maze, NULL, sx, sy, gx, gy, rng);
+}
+
+// Search over the N x N window of an unbounded chunk source starting at world
+// (originX, originY). Start and goal are window coordinates. The search is
+// sparse, so its memory follows the cells it touches however large the
+// window is, and the maze itself is bounded by the chunk cache.
+static inline void search_init_chunked(SearchState *s, int N, ChunkSource *chunks, int originX, int originY, int sx, int sy, int gx, int gy, Rng *rng) {
+    search_begin(s, SEARCH_LAYOUT, N, NULL, chunks, sx, sy, gx, gy, rng);
+    s->originX = originX;
+    s->originY = originY;
+}
+
+// Bytes held by the per-slot arrays (and the cell map of a sparse search)
+static inline size_t search_bytes(const SearchState *s) {
+    size_t bytes = (size_t)s->max * 7 * sizeof(int);
+    if (s->chunks) bytes += cell_map_bytes(&s->cells);
+    return bytes;
+}
+
+// Weight the search with a cost plane of the same size, or NULL for unit
+// costs. Call right after search_init, before the first step.
+static inline void search_set_costs(SearchState *s, const CostGrid *costs) {
+    s->costs = costs;
+}
+
+// Priority queue for Dijkstra and A* (other steppers ignore it). Call right
+// after search_init, before the first step.
+static inline void search_set_queue(SearchState *s, SearchQueue q) {
+    s->queueKind = q;
+}
+
+// Record the search's queue operations into trace (see QueueOp). Call
+// right after search_init, before the first step.
+static inline void search_set_trace(SearchState *s, QueueTrace *trace) {
+    s->trace = trace;
+}
+
+// Use neighbour masks built from the same maze in the search's layout
+// (ignored for chunked searches). Optional: without them search_neighbors()
+// reads the grid. Call right after search_init, before the first step.
+static inline void search_set_masks(SearchState *s, const NeighborMasks *masks) {
+    if (s->chunks) return;
+    if (masks && masks->layout != s->layout) {
+        qol_error("Neighbour masks in the %s layout given to a %s-layout search\n",
+                  LAYOUT_NAMES[masks->layout], LAYOUT_NAMES[s->layout]);
+        abort();
+    }
+    s->masks = masks;
+}
+
+// Consult a component index before searching: when start and goal are not
+// connected the search is marked unreachable and every step() returns false
+// at once instead of flooding the start's component. Returns whether a path
+// can exist.
+static inline bool search_check_components(SearchState *s, const ComponentIndex *ci) {
+    s->unreachable = !components_connected(ci, s->startX, s->startY, s->goalX, s->goalY);
+    return !s->unreachable;
+}
+
+// Cost of entering the cell at search index i
+static inline int search_cost(const SearchState *s, int i) {
+    return s->costs ? cost_get(s->costs, search_x(s, i), search_y(s, i)) : 1;
+}
+
+// Lower bound on the cost of any single move, so that Manhattan distance
+// times this stays an admissible heuristic
+static inline int search_min_cost(const SearchState *s) {
+    return s->costs ? s->costs->min : 1;
+}
+
+// Sum of the entry costs along the found path (the path length minus one
+// when unweighted)
+static inline long search_path_cost(const SearchState *s) {
+    long total = 0;
+    for (size_t i = 1; i < s->path.len; i++) {
+        total += s->costs ? cost_get(s->costs, s->path.data[i].x, s->path.data[i].y) : 1;
+    }
+    return total;
+}
+
+// Whether the search may step onto window cell (x, y)
+static inline bool search_open(SearchState *s, int x, int y) {
+    if (x < 0 || x >= s->N || y < 0 || y >= s->N) return false;
+    if (s->chunks) return chunk_get(s->chunks, s->originX + x, s->originY + y) == PATH;
+    return grid_get(s->maze, x, y) == PATH;
+}
+
+// Open neighbours of the cell at search index i as a mask over s->dirs: bit
+// k set means the step to search_move(s, i, k) is allowed. Steppers iterate its
+// set bits.
+static inline unsigned search_neighbors(SearchState *s, int i) {
+    if (s->masks) return s->remap[s->masks->bits[i]];
+    int x = search_x(s, i), y = search_y(s, i);
+    unsigned m = 0;
+    for (int k = 0; k < 4; k++) {
+        if (search_open(s, x + s->dirs[k][0], y + s->dirs[k][1])) m |= 1u << k;
+    }
+    return m;
 }
 
 static inline int build_path(SearchState *s) {
@@ -73,10 +382,11 @@ static inline int build_path(SearchState *s) {
 
     while (!(cx == s->startX && cy == s->startY)) {
         qol_push(&s->path, ((Cell){cx, cy}));
-        int p = s->parent[cy * s->N + cx];
+        int i = search_index(s, cx, cy);
+        int p = s->parent[i];
         if (p < 0) break;
-        cx = p % s->N;
-        cy = p / s->N;
+        cx = search_x(s, p);
+        cy = search_y(s, p);
     }
     qol_push(&s->path, ((Cell){s->startX, s->startY}));
 
@@ -96,6 +406,12 @@ static inline void search_free(SearchState *s) {
     free(s->fscore);
     free(s->heap);
     free(s->heap_pos);
+    if (s->buckets.head) bucket_queue_free(&s->buckets);
+    if (s->dial.head) dial_free(&s->dial);
+    radix_free(&s->radix);
+    if (s->pairing.key) pairing_free(&s->pairing);
+    qol_release(&s->lazy);
+    if (s->cells.keys) cell_map_free(&s->cells);
     qol_release(&s->queue);
     qol_release(&s->path);
 }
@@ -0,0 +1,309 @@
+#pragma once
+#include "grid.h"
+
+// Connected-component index: a dense component id for every open cell
+// (-1 for walls), so "is there a path?" is two loads and a compare.
+//
+// Built with union-find over the label array itself. Rows are split into
+// one band per thread and each band is unioned on its own thread (left and
+// up neighbours inside the band), then the band seams are unioned and a
+// single forward pass flattens and renumbers. Roots are always the smallest
+// cell index of their set, so every parent link points backwards and that
+// forward pass sees each parent resolved before its children.
+//
+// components_set() toggles one cell and repairs the index in place: opening
+// a cell relabels the smaller of the components it joins, closing one runs
+// a BFS from each open neighbour in lockstep and relabels only the pieces
+// that turn out to be cut off, so the cost follows the smaller side.
+typedef qol_list(int) ComponentList;
+
+typedef struct {
+    int N;
+    int *label;
+    ComponentList size;     // cells per component id, 0 for free ids
+    ComponentList freeIds;
+    int count;              // live components
+} ComponentIndex;
+
+static inline int components_find(int *parent, int a) {
+    while (parent[a] != a) {
+        parent[a] = parent[parent[a]];
+        a = parent[a];
+    }
+    return a;
+}
+
+static inline void components_union(int *parent, int a, int b) {
+    a = components_find(parent, a);
+    b = components_find(parent, b);
+    if (a < b) parent[b] = a;
+    else if (b < a) parent[a] = b;
+}
+
+typedef struct {
+    const Grid *maze;
+    int *label;
+    int y0, y1;
+} ComponentBand;
+
+static void *components_band(void *arg) {
+    ComponentBand *b = arg;
+    int N = b->maze->N;
+    for (int y = b->y0; y < b->y1; y++) {
+        for (int x = 0; x < N; x++) {
+            int i = y * N + x;
+            if (grid_get(b->maze, x, y) == WALL) {
+                b->label[i] = -1;
+                continue;
+            }
+            b->label[i] = i;
+            if (x > 0 && b->label[i - 1] >= 0) components_union(b->label, i - 1, i);
+            if (y > b->y0 && b->label[i - N] >= 0) components_union(b->label, i - N, i);
+        }
+    }
+    return NULL;
+}
+
+static inline int components_new_id(ComponentIndex *ci, int size) {
+    int id;
+    if (ci->freeIds.len > 0) {
+        id = ci->freeIds.data[--ci->freeIds.len];
+        ci->size.data[id] = size;
+    } else {
+        id = (int)ci->size.len;
+        qol_push(&ci->size, size);
+    }
+    ci->count++;
+    return id;
+}
+
+static inline void components_release_id(ComponentIndex *ci, int id) {
+    ci->size.data[id] = 0;
+    qol_push(&ci->freeIds, id);
+    ci->count--;
+}
+
+// Label every open cell of maze. threads <= 0 uses every online core; the
+// result does not depend on the thread count.
+static void components_build(ComponentIndex *ci, const Grid *maze, int threads) {
+    int N = maze->N;
+    memset(ci, 0, sizeof(*ci));
+    ci->N = N;
+    ci->label = malloc((size_t)N * N * sizeof(int));
+    if (!ci->label) {
+        qol_error("Component index out of memory (N = %d)\n", N);
+        abort();
+    }
+
+    if (threads <= 0) threads = (int)sysconf(_SC_NPROCESSORS_ONLN);
+    if (threads > N) threads = N;
+    if (threads < 1) threads = 1;
+    ComponentBand *bands = malloc((size_t)threads * sizeof(ComponentBand));
+    pthread_t *workers = malloc((size_t)threads * sizeof(pthread_t));
+    for (int t = 0; t < threads; t++) {
+        bands[t] = (ComponentBand){ maze, ci->label, (int)((long)N * t / threads), (int)((long)N * (t + 1) / threads) };
+    }
+    int started = 0;
+    for (int t = 1; t < threads; t++) {
+        if (pthread_create(&workers[started], NULL, components_band, &bands[t]) != 0) {
+            components_band(&bands[t]);
+            continue;
+        }
+        started++;
+    }
+    components_band(&bands[0]);
+    for (int t = 0; t < started; t++) pthread_join(workers[t], NULL);
+
+    // Seams between bands
+    for (int t = 1; t < threads; t++) {
+        int y = bands[t].y0;
+        for (int x = 0; x < N; x++) {
+            int i = y * N + x;
+            if (ci->label[i] >= 0 && ci->label[i - N] >= 0) components_union(ci->label, i - N, i);
+        }
+    }
+    free(workers);
+    free(bands);
+
+    // Parents point backwards, so one forward pass resolves every cell
+    for (int i = 0; i < N * N; i++) {
+        int p = ci->label[i];
+        if (p < 0) continue;
+        if (p == i) {
+            ci->label[i] = components_new_id(ci, 1);
+        } else {
+            ci->label[i] = ci->label[p];
+            ci->size.data[ci->label[i]]++;
+        }
+    }
+}
+
+static void components_free(ComponentIndex *ci) {
+    free(ci->label);
+    ci->label = NULL;
+    qol_release(&ci->size);
+    qol_release(&ci->freeIds);
+}
+
+static inline int components_get(const ComponentIndex *ci, int x, int y) {
+    return ci->label[y * ci->N + x];
+}
+
+// Whether open cells a and b are connected
+static inline bool components_connected(const ComponentIndex *ci, int ax, int ay, int bx, int by) {
+    int a = components_get(ci, ax, ay);
+    return a >= 0 && a == components_get(ci, bx, by);
+}
+
+// Flood the cells labelled `from` that are reachable from cell i with `to`
+static void components_relabel(ComponentIndex *ci, int i, int from, int to, ComponentList *queue) {
+    int N = ci->N;
+    queue->len = 0;
+    ci->label[i] = to;
+    qol_push(queue, i);
+    for (size_t h = 0; h < queue->len; h++) {
+        int c = queue->data[h];
+        int x = c % N, y = c / N;
+        for (int d = 0; d < 4; d++) {
+            int nx = x + dirs[d][0], ny = y + dirs[d][1];
+            if (nx < 0 || nx >= N || ny < 0 || ny >= N) continue;
+            int n = ny * N + nx;
+            if (ci->label[n] != from) continue;
+            ci->label[n] = to;
+            qol_push(queue, n);
+        }
+    }
+}
+
+static void components_open(ComponentIndex *ci, int x, int y) {
+    int N = ci->N;
+    int i = y * N + x;
+    int ids[4], cells[4], k = 0;
+    for (int d = 0; d < 4; d++) {
+        int nx = x + dirs[d][0], ny = y + dirs[d][1];
+        if (nx < 0 || nx >= N || ny < 0 || ny >= N) continue;
+        int id = ci->label[ny * N + nx];
+        if (id < 0) continue;
+        bool seen = false;
+        for (int j = 0; j < k; j++) seen |= ids[j] == id;
+        if (seen) continue;
+        ids[k] = id;
+        cells[k++] = ny * N + nx;
+    }
+    if (k == 0) {
+        ci->label[i] = components_new_id(ci, 1);
+        return;
+    }
+
+    int keep = 0;
+    for (int j = 1; j < k; j++) {
+        if (ci->size.data[ids[j]] > ci->size.data[ids[keep]]) keep = j;
+    }
+    ComponentList queue = {0};
+    for (int j = 0; j < k; j++) {
+        if (j == keep) continue;
+        components_relabel(ci, cells[j], ids[j], ids[keep], &queue);
+        ci->size.data[ids[keep]] += ci->size.data[ids[j]];
+        components_release_id(ci, ids[j]);
+    }
+    qol_release(&queue);
+    ci->label[i] = ids[keep];
+    ci->size.data[ids[keep]]++;
+}
+
+static inline int components_group(const int *group, int s) {
+    while (group[s] != s) s = group[s];
+    return s;
+}
+
+static void components_close(ComponentIndex *ci, int x, int y) {
+    int N = ci->N;
+    int i = y * N + x;
+    int old = ci->label[i];
+    ci->label[i] = -1;
+    ci->size.data[old]--;
+
+    int starts[4], k = 0;
+    for (int d = 0; d < 4; d++) {
+        int nx = x + dirs[d][0], ny = y + dirs[d][1];
+        if (nx >= 0 && nx < N && ny >= 0 && ny < N && ci->label[ny * N + nx] == old) starts[k++] = ny * N + nx;
+    }
+    if (k == 0) {
+        components_release_id(ci, old);
+        return;
+    }
+    if (k == 1) return;
+
+    // One BFS per neighbour, one expansion each per round. Visited cells are
+    // marked -2 - search in the label array. Searches that meet join a group;
+    // once at most one group can still grow, every finished group is a piece
+    // that has been cut off.
+    ComponentList queue[4] = {0};
+    size_t head[4] = {0};
+    int group[4];
+    for (int s = 0; s < k; s++) {
+        group[s] = s;
+        ci->label[starts[s]] = -2 - s;
+        qol_push(&queue[s], starts[s]);
+    }
+    while (true) {
+        int growing = -1;
+        bool several = false;
+        for (int s = 0; s < k; s++) {
+            if (head[s] >= queue[s].len) continue;
+            int g = components_group(group, s);
+            if (growing < 0) growing = g;
+            else if (g != growing) several = true;
+        }
+        if (!several) break;
+
+        for (int s = 0; s < k; s++) {
+            if (head[s] >= queue[s].len) continue;
+            int c = queue[s].data[head[s]++];
+            int cx = c % N, cy = c / N;
+            for (int d = 0; d < 4; d++) {
+                int nx = cx + dirs[d][0], ny = cy + dirs[d][1];
+                if (nx < 0 || nx >= N || ny < 0 || ny >= N) continue;
+                int n = ny * N + nx;
+                int l = ci->label[n];
+                if (l == old) {
+                    ci->label[n] = -2 - s;
+                    qol_push(&queue[s], n);
+                } else if (l <= -2) {
+                    int a = components_group(group, s), b = components_group(group, -2 - l);
+                    if (a != b) group[a < b ? b : a] = a < b ? a : b;
+                }
+            }
+        }
+    }
+
+    // The group still growing (or, if none is, the first one) keeps `old`;
+    // every other group becomes a new component
+    int keepGroup = -1;
+    for (int s = 0; s < k && keepGroup < 0; s++) {
+        if (head[s] < queue[s].len) keepGroup = components_group(group, s);
+    }
+    if (keepGroup < 0) keepGroup = components_group(group, 0);
+    int newId[4];
+    for (int s = 0; s < k; s++) newId[s] = -1;
+    for (int s = 0; s < k; s++) {
+        int g = components_group(group, s);
+        if (g == keepGroup) {
+            for (size_t j = 0; j < queue[s].len; j++) ci->label[queue[s].data[j]] = old;
+            continue;
+        }
+        if (newId[g] < 0) newId[g] = components_new_id(ci, 0);
+        for (size_t j = 0; j < queue[s].len; j++) ci->label[queue[s].data[j]] = newId[g];
+        ci->size.data[newId[g]] += (int)queue[s].len;
+        ci->size.data[old] -= (int)queue[s].len;
+    }
+    for (int s = 0; s < k; s++) qol_release(&queue[s]);
+}
+
+// Set cell (x, y) of maze to v (WALL or PATH) and update the index to match
+static void components_set(ComponentIndex *ci, Grid *maze, int x, int y, int v) {
+    if (grid_get(maze, x, y) == v) return;
+    grid_set(maze, x, y, v);
+    if (v == PATH) components_open(ci, x, y);
+    else components_close(ci, x, y);
+}
@@ -0,0 +1,40 @@
+#pragma once
+#include "../../libs/build.h"
+
+// Per-cell traversal cost, one byte per cell, row-major N x N, next to the
+// wall Grid. Entering a cell costs its value (1..255); walls ignore it.
+typedef struct {
+    int N;
+    uint8_t *cost;
+    int min;         // smallest cost present, scales the A* heuristic
+} CostGrid;
+
+static inline void cost_grid_init(CostGrid *c, int N) {
+    c->N = N;
+    c->cost = malloc((size_t)N * N);
+    if (!c->cost) {
+        qol_error("Cost grid out of memory (N = %d)\n", N);
+        abort();
+    }
+    memset(c->cost, 1, (size_t)N * N);
+    c->min = 1;
+}
+
+static inline void cost_grid_free(CostGrid *c) {
+    free(c->cost);
+    c->cost = NULL;
+}
+
+static inline int cost_get(const CostGrid *c, int x, int y) {
+    return c->cost[(size_t)y * c->N + x];
+}
+
+// Recompute min after editing the plane directly
+static inline void cost_grid_update_min(CostGrid *c) {
+    int m = 255;
+    size_t n = (size_t)c->N * c->N;
+    for (size_t i = 0; i < n && m > 1; i++) {
+        if (c->cost[i] < m) m = c->cost[i];
+    }
+    c->min = m < 1 ? 1 : m;
+}
@@ -0,0 +1,288 @@
+#pragma once
+#include "common.h"
+#include "heap.h"
+
+// Compressed-sparse-row adjacency of the open cells only. Node n is the open
+// cell cellOf[n]; its neighbours are adj[rowStart[n] .. rowStart[n + 1]).
+// Walls get no node, so every per-node array is sized to the open-cell
+// count instead of N * N, and a search never tests bounds or walls again.
+//
+// Nodes can be numbered in row-major order, in BFS order, or in reverse
+// Cuthill-McKee order (BFS from a peripheral node, neighbours by ascending
+// degree, then reversed). The last two keep neighbours' ids, and therefore
+// their dist/parent slots, close together.
+
+typedef enum {
+    CSR_ORDER_ROW,
+    CSR_ORDER_BFS,
+    CSR_ORDER_RCM,
+    CSR_ORDER_COUNT,
+} CsrOrder;
+
+static const char *CSR_ORDER_NAMES[CSR_ORDER_COUNT] = { "row-major", "BFS", "RCM" };
+
+typedef enum {
+    CSR_BFS,
+    CSR_DIJKSTRA,
+    CSR_ASTAR,
+} CsrAlgo;
+
+typedef struct {
+    int N;
+    int count;       // open cells = nodes
+    int *cellOf;     // node -> y * N + x
+    int *rowCell;    // open cells in ascending y * N + x, for csr_node()
+    int *rowNode;    // node of rowCell[i]
+    int *rowStart;   // count + 1 entries
+    int *adj;
+    uint8_t *cost;   // entry cost per node, NULL when unweighted
+    int minCost;
+} CsrGraph;
+
+// BFS from root over the row-major graph (rs, adj), appending to order.
+// With byDegree, each node's unvisited neighbours are taken in ascending
+// degree (Cuthill-McKee). Returns the last node reached.
+static int csr_bfs_order(const int *rs, const int *adj, int root, uint8_t *seen, int *order, int *len, bool byDegree) {
+    int head = *len;
+    order[(*len)++] = root;
+    seen[root] = 1;
+    while (head < *len) {
+        int u = order[head++];
+        int next[4], k = 0;
+        for (int e = rs[u]; e < rs[u + 1]; e++) {
+            int v = adj[e];
+            if (!seen[v]) {
+                seen[v] = 1;
+                next[k++] = v;
+            }
+        }
+        if (byDegree) {
+            for (int i = 1; i < k; i++) {
+                int v = next[i], j = i;
+                while (j > 0 && rs[next[j - 1] + 1] - rs[next[j - 1]] > rs[v + 1] - rs[v]) {
+                    next[j] = next[j - 1];
+                    j--;
+                }
+                next[j] = v;
+            }
+        }
+        for (int i = 0; i < k; i++) order[(*len)++] = next[i];
+    }
+    return order[*len - 1];
+}
+
+// Build the graph of maze, numbered in the given order. costs is optional
+// and copied into node order.
+static void csr_build(CsrGraph *g, const Grid *maze, const CostGrid *costs, CsrOrder order) {
+    int N = maze->N;
+    memset(g, 0, sizeof(*g));
+    g->N = N;
+
+    // Row-major numbering first; the N * N lookup only lives during the build
+    int *id = malloc((size_t)N * N * sizeof(int));
+    int count = 0;
+    for (int y = 0; y < N; y++) {
+        for (int x = 0; x < N; x++) id[y * N + x] = grid_get(maze, x, y) == PATH ? count++ : -1;
+    }
+    int *cellOf = malloc((size_t)(count ? count : 1) * sizeof(int));
+    int *rs = malloc(((size_t)count + 1) * sizeof(int));
+    qol_list(int) adj = {0};
+    int n = 0;
+    for (int y = 0; y < N; y++) {
+        for (int x = 0; x < N; x++) {
+            if (id[y * N + x] < 0) continue;
+            cellOf[n] = y * N + x;
+            rs[n++] = (int)adj.len;
+            for (int i = 0; i < 4; i++) {
+                int nx = x + dirs[i][0], ny = y + dirs[i][1];
+                if (nx >= 0 && nx < N && ny >= 0 && ny < N && id[ny * N + nx] >= 0) qol_push(&adj, id[ny * N + nx]);
+            }
+        }
+    }
+    rs[count] = (int)adj.len;
+    free(id);
+
+    // perm[new] = old
+    int *perm = malloc((size_t)(count ? count : 1) * sizeof(int));
+    if (order == CSR_ORDER_ROW) {
+        for (int i = 0; i < count; i++) perm[i] = i;
+    } else {
+        uint8_t *seen = calloc((size_t)count + 1, 1);
+        int len = 0;
+        bool rcm = order == CSR_ORDER_RCM;
+        for (int root = 0; root < count; root++) {
+            if (seen[root]) continue;
+            int start = root;
+            if (rcm) {
+                // Pseudo-peripheral start: the last node of a BFS from root,
+                // found with a throwaway sweep over this component
+                int mark = len;
+                start = csr_bfs_order(rs, adj.data, root, seen, perm, &len, false);
+                for (int i = mark; i < len; i++) seen[perm[i]] = 0;
+                len = mark;
+            }
+            csr_bfs_order(rs, adj.data, start, seen, perm, &len, rcm);
+        }
+        free(seen);
+        if (rcm) {
+            for (int i = 0; i < count / 2; i++) {
+                int t = perm[i];
+                perm[i] = perm[count - 1 - i];
+                perm[count - 1 - i] = t;
+            }
+        }
+    }
+
+    int *inv = malloc((size_t)(count ? count : 1) * sizeof(int));
+    for (int i = 0; i < count; i++) inv[perm[i]] = i;
+    g->count = count;
+    g->cellOf = malloc((size_t)(count ? count : 1) * sizeof(int));
+    g->rowStart = malloc(((size_t)count + 1) * sizeof(int));
+    g->adj = malloc((adj.len ? adj.len : 1) * sizeof(int));
+    int e = 0;
+    for (int i = 0; i < count; i++) {
+        int old = perm[i];
+        g->cellOf[i] = cellOf[old];
+        g->rowStart[i] = e;
+        for (int k = rs[old]; k < rs[old + 1]; k++) g->adj[e++] = inv[adj.data[k]];
+    }
+    g->rowStart[count] = e;
+    g->minCost = 1;
+    if (costs) {
+        g->cost = malloc((size_t)(count ? count : 1));
+        for (int i = 0; i < count; i++) g->cost[i] = costs->cost[g->cellOf[i]];
+        g->minCost = costs->min;
+    }
+    g->rowCell = cellOf;
+    g->rowNode = inv;
+    free(perm);
+    free(rs);
+    qol_release(&adj);
+}
+
+static void csr_free(CsrGraph *g) {
+    free(g->cellOf);
+    free(g->rowCell);
+    free(g->rowNode);
+    free(g->rowStart);
+    free(g->adj);
+    free(g->cost);
+    memset(g, 0, sizeof(*g));
+}
+
+// Node of cell (x, y), or -1 for walls: a binary search of the row-major
+// cell list, O(log count)
+static int csr_node(const CsrGraph *g, int x, int y) {
+    int cell = y * g->N + x;
+    int lo = 0, hi = g->count;
+    while (lo < hi) {
+        int mid = lo + (hi - lo) / 2;
+        if (g->rowCell[mid] < cell) lo = mid + 1;
+        else hi = mid;
+    }
+    return lo < g->count && g->rowCell[lo] == cell ? g->rowNode[lo] : -1;
+}
+
+// Average |id(u) - id(v)| over all edges; smaller means neighbours share
+// cache lines more often
+static double csr_mean_gap(const CsrGraph *g) {
+    int edges = g->rowStart[g->count];
+    if (edges == 0) return 0.0;
+    double sum = 0.0;
+    for (int u = 0; u < g->count; u++) {
+        for (int e = g->rowStart[u]; e < g->rowStart[u + 1]; e++) sum += abs(g->adj[e] - u);
+    }
+    return sum / edges;
+}
+
+// Per-query arrays, one slot per node
+typedef struct {
+    int *dist;
+    int *parent;
+    int *heap;       // binary DHeap (heap.h) on key (BFS uses it as a FIFO)
+    int *heapPos;
+    int *key;
+    int heapLen;
+} CsrSearch;
+
+static void csr_search_init(CsrSearch *cs, const CsrGraph *g) {
+    size_t n = g->count ? (size_t)g->count : 1;
+    cs->dist = malloc(n * sizeof(int));
+    cs->parent = malloc(n * sizeof(int));
+    cs->heap = malloc(n * sizeof(int));
+    cs->heapPos = malloc(n * sizeof(int));
+    cs->key = malloc(n * sizeof(int));
+    cs->heapLen = 0;
+}
+
+static void csr_search_free(CsrSearch *cs) {
+    free(cs->dist);
+    free(cs->parent);
+    free(cs->heap);
+    free(cs->heapPos);
+    free(cs->key);
+}
+
+// Search from node src to node dst (see csr_node) over the CSR graph and
+// fill s->path. Only the goal and path fields of s are used. Returns whether
+// the goal was reached; *expansions counts the nodes settled.
+static bool csr_solve(const CsrGraph *g, CsrSearch *cs, SearchState *s, int src, int dst, CsrAlgo algo, long *expansions) {
+    int N = g->N;
+    *expansions = 0;
+    s->path.len = 0;
+    if (src < 0 || dst < 0) return false;
+
+    for (int i = 0; i < g->count; i++) {
+        cs->dist[i] = INF;
+        cs->parent[i] = -1;
+        cs->heapPos[i] = -1;
+    }
+    cs->dist[src] = 0;
+    int head = 0, tail = 0;
+    cs->heapLen = 0;
+    DHeap heap = { cs->heap, cs->heapPos, &cs->heapLen, cs->key, cs->dist };
+    if (algo == CSR_BFS) {
+        cs->heap[tail++] = src;
+    } else {
+        cs->key[src] = 0;
+        dheap_update(&heap, src, 2);
+    }
+
+    int gx = s->goalX, gy = s->goalY;
+    bool found = false;
+    while (algo == CSR_BFS ? head < tail : cs->heapLen > 0) {
+        int u = algo == CSR_BFS ? cs->heap[head++] : dheap_pop(&heap, 2);
+        (*expansions)++;
+        if (u == dst) {
+            found = true;
+            break;
+        }
+        for (int e = g->rowStart[u]; e < g->rowStart[u + 1]; e++) {
+            int v = g->adj[e];
+            if (algo == CSR_BFS) {
+                if (cs->dist[v] != INF) continue;
+                cs->dist[v] = cs->dist[u] + 1;
+                cs->parent[v] = u;
+                cs->heap[tail++] = v;
+                continue;
+            }
+            int nd = cs->dist[u] + (g->cost ? g->cost[v] : 1);
+            if (nd >= cs->dist[v]) continue;
+            cs->dist[v] = nd;
+            cs->parent[v] = u;
+            int h = 0;
+            if (algo == CSR_ASTAR) h = (abs(g->cellOf[v] % N - gx) + abs(g->cellOf[v] / N - gy)) * g->minCost;
+            cs->key[v] = nd + h;
+            dheap_update(&heap, v, 2);
+        }
+    }
+    if (!found) return false;
+
+    for (int v = dst; v >= 0; v = cs->parent[v]) qol_push(&s->path, ((Cell){ g->cellOf[v] % N, g->cellOf[v] / N }));
+    for (size_t i = 0; i < s->path.len / 2; i++) {
+        Cell t = s->path.data[i];
+        s->path.data[i] = s->path.data[s->path.len - 1 - i];
+        s->path.data[s->path.len - 1 - i] = t;
+    }
+    return true;
+}
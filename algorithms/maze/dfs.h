@@ -5,9 +5,10 @@
 
 // Depth-first search step
 static inline bool step(SearchState *s) {
+    if (s->unreachable) return false;
     if (s->queue.len == 0) return false;
     Cell c = s->queue.data[s->queue.len - 1];
-    drop(&s->queue);
+    qol_drop(&s->queue);
     int x = c.x, y = c.y;
 
     if (x == s->goalX && y == s->goalY) {
@@ -15,16 +16,14 @@ static inline bool step(SearchState *s) {
         return true;
     }
 
-    for (int i = 0; i < 4; i++) {
-        int nx = x + dirs[i][0];
-        int ny = y + dirs[i][1];
-        if (nx >= 0 && nx < s->N && ny >= 0 && ny < s->N && s->maze[ny][nx] == PATH) {
-            int idx = ny * s->N + nx;
-            if (!s->visited[idx]) {
-                s->visited[idx] = 1;
-                s->parent[idx] = y * s->N + x;
-                push(&s->queue, ((Cell){nx, ny}));
-            }
+    int cur = search_index(s, x, y);
+    for (unsigned m = search_neighbors(s, cur); m; m &= m - 1) {
+        int i = __builtin_ctz(m);
+        int idx = search_move(s, cur, i);
+        if (!s->visited[idx]) {
+            s->visited[idx] = 1;
+            s->parent[idx] = cur;
+            qol_push(&s->queue, ((Cell){x + s->dirs[i][0], y + s->dirs[i][1]}));
         }
     }
     return false;
@@ -0,0 +1,94 @@
+#pragma once
+#include "../../libs/build.h"
+
+// Dial's bucket queue for monotone integer keys: every key in the queue lies
+// in [cur, cur + spread], where cur is the key last popped and spread bounds
+// how far one relaxation can raise a key above it (the largest edge weight,
+// plus the heuristic's swing for A*). A ring of spread + 1 buckets, rounded
+// up to a power of two, then holds each key in its own bucket. Buckets are
+// doubly linked through per-slot arrays, so a decreased key is unlinked and
+// relinked in O(1) and every slot is queued at most once; pop advances the
+// cursor past empty buckets, at most a ring per pop.
+typedef struct {
+    int mask;        // ring size - 1
+    int *head;       // per bucket, first slot or -1
+    int *next;       // per slot
+    int *prev;       // per slot, -1 at the head of a bucket
+    int *key;        // per slot, its key while queued, -1 otherwise
+    int cur;         // no queued key is below cur; INT_MAX before the first push
+    int len;
+} DialQueue;
+
+static inline void dial_init(DialQueue *q, int spread, int slots) {
+    int ring = 1;
+    while (ring < spread + 1) ring <<= 1;
+    q->mask = ring - 1;
+    q->head = malloc((size_t)ring * sizeof(int));
+    q->next = malloc((size_t)slots * sizeof(int));
+    q->prev = malloc((size_t)slots * sizeof(int));
+    q->key = malloc((size_t)slots * sizeof(int));
+    if (!q->head || !q->next || !q->prev || !q->key) {
+        qol_error("Dial queue out of memory (%d buckets, %d slots)\n", ring, slots);
+        abort();
+    }
+    for (int b = 0; b < ring; b++) q->head[b] = -1;
+    for (int i = 0; i < slots; i++) q->key[i] = -1;
+    q->cur = INT_MAX;
+    q->len = 0;
+}
+
+static inline void dial_free(DialQueue *q) {
+    free(q->head);
+    free(q->next);
+    free(q->prev);
+    free(q->key);
+    q->head = NULL;
+}
+
+// Make room for slots [old, slots) after the search gained slots
+static inline void dial_grow(DialQueue *q, int old, int slots) {
+    int *next = realloc(q->next, (size_t)slots * sizeof(int));
+    int *prev = next ? realloc(q->prev, (size_t)slots * sizeof(int)) : NULL;
+    int *key = prev ? realloc(q->key, (size_t)slots * sizeof(int)) : NULL;
+    if (!key) {
+        qol_error("Dial queue out of memory (%d slots)\n", slots);
+        abort();
+    }
+    q->next = next;
+    q->prev = prev;
+    q->key = key;
+    for (int i = old; i < slots; i++) q->key[i] = -1;
+}
+
+static inline void dial_unlink(DialQueue *q, int slot) {
+    int b = q->key[slot] & q->mask;
+    if (q->prev[slot] >= 0) q->next[q->prev[slot]] = q->next[slot];
+    else q->head[b] = q->next[slot];
+    if (q->next[slot] >= 0) q->prev[q->next[slot]] = q->prev[slot];
+    q->key[slot] = -1;
+    q->len--;
+}
+
+// Insert slot with key, or move it there if it is queued already. The key
+// must not be below the last popped one, so cur only moves down for the
+// very first push.
+static inline void dial_push(DialQueue *q, int slot, int key) {
+    if (q->key[slot] >= 0) dial_unlink(q, slot);
+    if (q->len == 0 && key < q->cur) q->cur = key;
+    int b = key & q->mask;
+    q->key[slot] = key;
+    q->prev[slot] = -1;
+    q->next[slot] = q->head[b];
+    if (q->head[b] >= 0) q->prev[q->head[b]] = slot;
+    q->head[b] = slot;
+    q->len++;
+}
+
+// Remove and return a slot with the smallest key, -1 when empty
+static inline int dial_pop(DialQueue *q) {
+    if (q->len == 0) return -1;
+    while (q->head[q->cur & q->mask] < 0) q->cur++;
+    int slot = q->head[q->cur & q->mask];
+    dial_unlink(q, slot);
+    return slot;
+}
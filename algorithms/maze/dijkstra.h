@@ -1,88 +1,22 @@
 #pragma once
 #include "common.h"
-
-#define ALGO_NAME "Dijkstra"
-
-static inline void heap_swap(SearchState *s, int a, int b) {
-    int va = s->heap[a];
-    int vb = s->heap[b];
-    s->heap[a] = vb;
-    s->heap[b] = va;
-    s->heap_pos[va] = b;
-    s->heap_pos[vb] = a;
-}
-
-static inline void heap_up(SearchState *s, int idx) {
-    while (idx > 0) {
-        int parent = (idx - 1) / 2;
-        if (s->dist[s->heap[idx]] >= s->dist[s->heap[parent]]) break;
-        heap_swap(s, idx, parent);
-        idx = parent;
-    }
-}
-
-static inline void heap_down(SearchState *s, int idx) {
-    while (true) {
-        int left = 2 * idx + 1;
-        int right = left + 1;
-        int smallest = idx;
-        if (left < s->heap_len && s->dist[s->heap[left]] < s->dist[s->heap[smallest]]) {
-            smallest = left;
-        }
-        if (right < s->heap_len && s->dist[s->heap[right]] < s->dist[s->heap[smallest]]) {
-            smallest = right;
-        }
-        if (smallest == idx) break;
-        heap_swap(s, idx, smallest);
-        idx = smallest;
-    }
-}
-
-static inline void heap_push(SearchState *s, int cell) {
-    s->heap[s->heap_len] = cell;
-    s->heap_pos[cell] = s->heap_len;
-    heap_up(s, s->heap_len);
-    s->heap_len++;
-}
-
-static inline int heap_pop(SearchState *s) {
-    if (s->heap_len == 0) return -1;
-    int top = s->heap[0];
-    s->heap_len--;
-    if (s->heap_len > 0) {
-        s->heap[0] = s->heap[s->heap_len];
-        s->heap_pos[s->heap[0]] = 0;
-        heap_down(s, 0);
+#include "pqueue.h"
+
+// Dijkstra step over the queue picked with search_set_queue() (see
+// pqueue.h), keyed on fscore = g; edge weight is the cost of the cell entered
+static inline bool dijkstra_step(SearchState *s) {
+    if (s->unreachable) return false;
+    int startIdx = search_index(s, s->startX, s->startY);
+    if (!s->processed[startIdx] && s->fscore[startIdx] == INF) {
+        s->fscore[startIdx] = 0;
+        search_queue_push(s, startIdx);
     }
-    s->heap_pos[top] = -1;
-    return top;
-}
 
-static inline void heap_decrease_key(SearchState *s, int cell) {
-    int pos = s->heap_pos[cell];
-    if (pos >= 0) heap_up(s, pos);
-    else heap_push(s, cell);
-}
-
-// Dijkstra step (using min-heap)
-static inline bool step(SearchState *s) {
-    if (s->heap_len == 0) {
-        int startIdx = s->startY * s->N + s->startX;
-        heap_push(s, startIdx);
-    }
-
-    int bestIdx = -1;
-    while (s->heap_len > 0) {
-        int candidate = heap_pop(s);
-        if (candidate == -1) break;
-        if (s->processed[candidate]) continue;
-        bestIdx = candidate;
-        break;
-    }
+    int bestIdx = search_queue_pop(s);
     if (bestIdx == -1) return false;
 
-    int x = bestIdx % s->N;
-    int y = bestIdx / s->N;
+    int x = search_x(s, bestIdx);
+    int y = search_y(s, bestIdx);
     s->processed[bestIdx] = 1;
 
     if (x == s->goalX && y == s->goalY) {
@@ -90,20 +24,26 @@ static inline bool step(SearchState *s) {
         return true;
     }
 
-    for (int i = 0; i < 4; i++) {
-        int nx = x + dirs[i][0];
-        int ny = y + dirs[i][1];
-        if (nx >= 0 && nx < s->N && ny >= 0 && ny < s->N && s->maze[ny][nx] == PATH) {
-            int idx = ny * s->N + nx;
-            if (s->processed[idx]) continue;
-            int nd = s->dist[y * s->N + x] + 1;
-            if (nd < s->dist[idx]) {
-                s->dist[idx] = nd;
-                s->parent[idx] = y * s->N + x;
-                s->visited[idx] = 1;
-                heap_decrease_key(s, idx);
-            }
+    for (unsigned m = search_neighbors(s, bestIdx); m; m &= m - 1) {
+        int idx = search_move(s, bestIdx, __builtin_ctz(m));
+        if (s->processed[idx]) continue;
+        int nd = s->dist[bestIdx] + search_cost(s, idx);
+        if (nd < s->dist[idx]) {
+            s->dist[idx] = nd;
+            s->fscore[idx] = nd;
+            s->parent[idx] = bestIdx;
+            s->visited[idx] = 1;
+            search_queue_push(s, idx);
         }
     }
     return false;
 }
+
+// The step() of the build when Dijkstra is the stepper selected in maze.h;
+// otherwise only dijkstra_step() is defined, for the benches
+#ifndef ALGO_NAME
+#define ALGO_NAME "Dijkstra"
+static inline bool step(SearchState *s) {
+    return dijkstra_step(s);
+}
+#endif
@@ -0,0 +1,49 @@
+#pragma once
+#include "common.h"
+
+// Runtime wall edits on a generated maze. An edit updates the wall grid,
+// its neighbour masks and the component index together, so "is the goal
+// still reachable" stays two loads however many walls have moved (see
+// components_set() for the repair: opening relabels the smaller side,
+// closing races one BFS per neighbour and stops once only one can grow).
+//
+// A running search keeps its state unless the edit reaches cells it has
+// already looked at. The steppers read a cell's walls when they expand it,
+// so a cell the search has neither discovered nor discovered a neighbour of
+// will be seen as it is when the frontier gets there. Otherwise the search
+// must restart. Once the path is found, closing a cell matters only if it
+// is on the path (removing cells never shortens one) and opening one only
+// if it borders a discovered cell.
+
+// Whether setting window cell (x, y) to the other value can change what
+// search s has done so far
+static inline bool search_touches(SearchState *s, int x, int y) {
+    bool opening = grid_get(s->maze, x, y) == WALL;
+    if (s->path.len > 0 && !opening) {
+        for (size_t i = 0; i < s->path.len; i++) {
+            if (s->path.data[i].x == x && s->path.data[i].y == y) return true;
+        }
+        return false;
+    }
+    if (s->path.len == 0 && s->visited[search_index(s, x, y)]) return true;
+    for (int d = 0; d < 4; d++) {
+        int nx = x + dirs[d][0], ny = y + dirs[d][1];
+        if (nx < 0 || nx >= s->N || ny < 0 || ny >= s->N) continue;
+        if (s->visited[search_index(s, nx, ny)]) return true;
+    }
+    return false;
+}
+
+// Set cell (x, y) of maze to v (WALL or PATH), refresh masks (optional) and
+// ci, and bring search s (optional, over the same maze) up to date. Returns
+// whether s has to be restarted; if not, its unreachable flag now follows
+// the new connectivity, so a search stalled on a cut-off goal resumes once
+// a wall opens up.
+static bool dynamic_set(Grid *maze, NeighborMasks *masks, ComponentIndex *ci, SearchState *s, int x, int y, int v) {
+    if (grid_get(maze, x, y) == v) return false;
+    bool restart = s && search_touches(s, x, y);
+    components_set(ci, maze, x, y, v);
+    if (masks) neighbor_masks_update(masks, maze, x, y);
+    if (s && !restart) search_check_components(s, ci);
+    return restart;
+}
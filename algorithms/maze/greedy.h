@@ -3,25 +3,28 @@
 
 #define ALGO_NAME "Greedy"
 
-// Greedy best-first step
+// Manhattan distance to the goal, in [0, 2N - 2]
+static inline int greedy_h(const SearchState *s, int i) {
+    return abs(search_x(s, i) - s->goalX) + abs(search_y(s, i) - s->goalY);
+}
+
+// Greedy best-first step. The open set is a bucket queue on h: a neighbour's
+// h is within one of its parent's, so the cursor barely moves and every
+// push and pop is O(1). Cells enter it once, when first discovered; equal h
+// pops the newest first, which keeps following the current corridor.
 static inline bool step(SearchState *s) {
-    int bestIdx = -1;
-    int bestScore = INF;
-    for (int i = 0; i < s->max; i++) {
-        if (s->visited[i] && !s->processed[i]) {
-            int cx = i % s->N;
-            int cy = i / s->N;
-            int h = abs(cx - s->goalX) + abs(cy - s->goalY);
-            if (h < bestScore) {
-                bestScore = h;
-                bestIdx = i;
-            }
-        }
+    if (s->unreachable) return false;
+    if (!s->buckets.head) {
+        bucket_queue_init(&s->buckets, 2 * s->N - 1, s->max);
+        int startIdx = search_index(s, s->startX, s->startY);
+        bucket_queue_push(&s->buckets, startIdx, greedy_h(s, startIdx));
     }
+
+    int bestIdx = bucket_queue_pop(&s->buckets);
     if (bestIdx == -1) return false;
 
-    int x = bestIdx % s->N;
-    int y = bestIdx / s->N;
+    int x = search_x(s, bestIdx);
+    int y = search_y(s, bestIdx);
     s->processed[bestIdx] = 1;
 
     if (x == s->goalX && y == s->goalY) {
@@ -29,15 +32,12 @@ static inline bool step(SearchState *s) {
         return true;
     }
 
-    for (int i = 0; i < 4; i++) {
-        int nx = x + dirs[i][0];
-        int ny = y + dirs[i][1];
-        if (nx >= 0 && nx < s->N && ny >= 0 && ny < s->N && s->maze[ny][nx] == PATH) {
-            int idx = ny * s->N + nx;
-            if (!s->visited[idx]) {
-                s->visited[idx] = 1;
-                s->parent[idx] = y * s->N + x;
-            }
+    for (unsigned m = search_neighbors(s, bestIdx); m; m &= m - 1) {
+        int idx = search_move(s, bestIdx, __builtin_ctz(m));
+        if (!s->visited[idx]) {
+            s->visited[idx] = 1;
+            s->parent[idx] = bestIdx;
+            bucket_queue_push(&s->buckets, idx, greedy_h(s, idx));
         }
     }
     return false;
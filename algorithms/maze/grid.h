@@ -0,0 +1,46 @@
+#pragma once
+#include "../../libs/build.h"
+
+// Bit-packed maze grid: one bit per cell (WALL = 1, PATH = 0), every row
+// padded to a whole number of 64-bit words, all rows in one allocation.
+// Padding bits past N are kept as WALL.
+typedef struct {
+    int N;
+    int stride;      // 64-bit words per row
+    uint64_t *bits;
+} Grid;
+
+static inline void grid_init(Grid *g, int N) {
+    g->N = N;
+    g->stride = (N + 63) / 64;
+    g->bits = malloc((size_t)g->stride * N * sizeof(uint64_t));
+    if (!g->bits) {
+        qol_error("Grid out of memory (N = %d)\n", N);
+        abort();
+    }
+}
+
+static inline void grid_free(Grid *g) {
+    free(g->bits);
+    g->bits = NULL;
+}
+
+static inline uint64_t *grid_row(const Grid *g, int y) {
+    return g->bits + (size_t)y * g->stride;
+}
+
+static inline int grid_get(const Grid *g, int x, int y) {
+    return (int)((grid_row(g, y)[x >> 6] >> (x & 63)) & 1);
+}
+
+static inline void grid_set(Grid *g, int x, int y, int v) {
+    uint64_t *w = &grid_row(g, y)[x >> 6];
+    uint64_t m = (uint64_t)1 << (x & 63);
+    if (v == WALL) *w |= m;
+    else *w &= ~m;
+}
+
+// Reset every cell (and the row padding) to WALL
+static inline void grid_clear(Grid *g) {
+    memset(g->bits, 0xff, (size_t)g->stride * g->N * sizeof(uint64_t));
+}
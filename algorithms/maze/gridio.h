@@ -0,0 +1,136 @@
+#pragma once
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include "grid.h"
+
+// Consumer of bit-packed grid rows (same layout as Grid: `stride` 64-bit
+// words per row, WALL = 1, padding bits WALL). Rows arrive in order, y = 0..
+typedef void (*MazeRowSink)(void *user, int y, const uint64_t *row, int stride);
+
+// Copy streamed rows into a Grid of matching width
+static void grid_row_sink(void *user, int y, const uint64_t *row, int stride) {
+    Grid *g = user;
+    memcpy(grid_row(g, y), row, (size_t)stride * sizeof(uint64_t));
+}
+
+// Append streamed rows to a FILE* as raw little-endian words
+static void file_row_sink(void *user, int y, const uint64_t *row, int stride) {
+    QOL_UNUSED(y);
+    FILE *f = user;
+    if (fwrite(row, sizeof(uint64_t), (size_t)stride, f) != (size_t)stride) {
+        qol_error("Failed to write maze row %d\n", y);
+        abort();
+    }
+}
+
+// On-disk maze: a fixed header, zero padded to MAZE_FILE_ALIGN bytes,
+// followed by the cells in Grid layout (height rows of `stride` words).
+// The payload is page aligned so a read-only mmap of the file can be used as
+// a Grid directly. Integers are stored little-endian (host order on every
+// platform we build for).
+#define MAZE_FILE_MAGIC "MAZEBITS"
+#define MAZE_FILE_VERSION 1
+#define MAZE_FILE_ALIGN 4096
+#define MAZE_FILE_GEN_UNKNOWN 0xffffffffu
+
+typedef struct {
+    char magic[8];
+    uint32_t version;
+    uint32_t headerSize;  // byte offset of the cells, multiple of MAZE_FILE_ALIGN
+    uint32_t width;
+    uint32_t height;
+    uint32_t stride;      // 64-bit words per row
+    uint32_t generator;   // MazeGen, or MAZE_FILE_GEN_UNKNOWN
+    uint64_t seed;
+    int32_t startX, startY;
+    int32_t goalX, goalY;
+} MazeFileHeader;
+
+static inline void maze_file_header_init(MazeFileHeader *h, int width, int height, uint32_t generator, uint64_t seed) {
+    memset(h, 0, sizeof(*h));
+    memcpy(h->magic, MAZE_FILE_MAGIC, sizeof(h->magic));
+    h->version = MAZE_FILE_VERSION;
+    h->headerSize = MAZE_FILE_ALIGN;
+    h->width = (uint32_t)width;
+    h->height = (uint32_t)height;
+    h->stride = (uint32_t)((width + 63) / 64);
+    h->generator = generator;
+    h->seed = seed;
+}
+
+// Write the header and its padding; the rows follow (e.g. via file_row_sink)
+static bool maze_file_write_header(FILE *f, const MazeFileHeader *h) {
+    static const uint8_t zeros[MAZE_FILE_ALIGN] = {0};
+    if (fwrite(h, sizeof(*h), 1, f) != 1) return false;
+    return fwrite(zeros, 1, h->headerSize - sizeof(*h), f) == h->headerSize - sizeof(*h);
+}
+
+static bool maze_file_save(const char *path, const Grid *g, const MazeFileHeader *h) {
+    FILE *f = fopen(path, "wb");
+    if (!f) {
+        qol_error("Could not open %s for writing\n", path);
+        return false;
+    }
+    size_t words = (size_t)g->stride * g->N;
+    bool ok = maze_file_write_header(f, h) && fwrite(g->bits, sizeof(uint64_t), words, f) == words;
+    ok = (fclose(f) == 0) && ok;
+    if (!ok) qol_error("Failed to write %s\n", path);
+    return ok;
+}
+
+// A maze file mapped read-only. grid.bits points into the mapping, so the
+// grid must not be written to or passed to grid_free().
+typedef struct {
+    MazeFileHeader header;
+    Grid grid;
+    void *map;
+    size_t mapSize;
+} MazeFile;
+
+static bool maze_file_open(const char *path, MazeFile *mf) {
+    memset(mf, 0, sizeof(*mf));
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) {
+        qol_error("Could not open %s\n", path);
+        return false;
+    }
+    struct stat st;
+    if (fstat(fd, &st) != 0 || (size_t)st.st_size < sizeof(MazeFileHeader)) {
+        qol_error("%s is not a maze file\n", path);
+        close(fd);
+        return false;
+    }
+    void *map = mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if (map == MAP_FAILED) {
+        qol_error("Could not map %s\n", path);
+        return false;
+    }
+
+    const MazeFileHeader *h = map;
+    size_t cells = (size_t)h->stride * h->height * sizeof(uint64_t);
+    const char *problem = NULL;
+    if (memcmp(h->magic, MAZE_FILE_MAGIC, sizeof(h->magic)) != 0) problem = "bad magic";
+    else if (h->version != MAZE_FILE_VERSION) problem = "unsupported version";
+    else if (h->headerSize < sizeof(*h) || h->headerSize % MAZE_FILE_ALIGN != 0) problem = "bad header size";
+    else if (h->stride != (h->width + 63) / 64) problem = "bad row stride";
+    else if ((size_t)st.st_size < h->headerSize + cells) problem = "truncated cell data";
+    if (problem) {
+        qol_error("%s: %s\n", path, problem);
+        munmap(map, (size_t)st.st_size);
+        return false;
+    }
+
+    mf->header = *h;
+    mf->map = map;
+    mf->mapSize = (size_t)st.st_size;
+    mf->grid.N = (int)h->width;
+    mf->grid.stride = (int)h->stride;
+    mf->grid.bits = (uint64_t *)((char *)map + h->headerSize);
+    return true;
+}
+
+static void maze_file_close(MazeFile *mf) {
+    if (mf->map) munmap(mf->map, mf->mapSize);
+    memset(mf, 0, sizeof(*mf));
+}
@@ -0,0 +1,98 @@
+#pragma once
+#include "common.h"
+
+// Indexed d-ary min-heap over int slots. DHeap is a view of arrays the
+// owner keeps: heap holds the slots in heap order and pos[i] is the
+// position of slot i in it, -1 when it is not in it, so a slot whose key
+// dropped is moved up in O(log n) instead of being pushed again. The arity
+// is a constant at every call site (2, 4 or 8, see pqueue.h): wider nodes
+// make the heap shallower, so pushes and decreases climb fewer levels while
+// pops compare more children per level.
+//
+// Equal keys pop the slot with the larger tie first. The searches use their
+// dist there: on a plateau of equal f that is the slot closest to the goal,
+// so A* settles one line of the plateau instead of fanning out across it.
+typedef struct {
+    int *heap;
+    int *pos;
+    int *len;
+    const int *key;
+    const int *tie;
+} DHeap;
+
+static inline bool dheap_less(const DHeap *h, int a, int b) {
+    if (h->key[a] != h->key[b]) return h->key[a] < h->key[b];
+    return h->tie[a] > h->tie[b];
+}
+
+static inline void dheap_place(const DHeap *h, int pos, int slot) {
+    h->heap[pos] = slot;
+    h->pos[slot] = pos;
+}
+
+static inline void dheap_up(const DHeap *h, int pos, int arity) {
+    int slot = h->heap[pos];
+    while (pos > 0) {
+        int parent = (pos - 1) / arity;
+        if (!dheap_less(h, slot, h->heap[parent])) break;
+        dheap_place(h, pos, h->heap[parent]);
+        pos = parent;
+    }
+    dheap_place(h, pos, slot);
+}
+
+static inline void dheap_down(const DHeap *h, int pos, int arity) {
+    int slot = h->heap[pos];
+    int len = *h->len;
+    while (true) {
+        int first = arity * pos + 1;
+        if (first >= len) break;
+        int last = first + arity < len ? first + arity : len;
+        int child = first;
+        for (int c = first + 1; c < last; c++) {
+            if (dheap_less(h, h->heap[c], h->heap[child])) child = c;
+        }
+        if (!dheap_less(h, h->heap[child], slot)) break;
+        dheap_place(h, pos, h->heap[child]);
+        pos = child;
+    }
+    dheap_place(h, pos, slot);
+}
+
+// Insert slot, or move it up after its key decreased
+static inline void dheap_update(const DHeap *h, int slot, int arity) {
+    int pos = h->pos[slot];
+    if (pos < 0) {
+        pos = (*h->len)++;
+        dheap_place(h, pos, slot);
+    }
+    dheap_up(h, pos, arity);
+}
+
+// Remove and return the slot with the smallest key, -1 when empty
+static inline int dheap_pop(const DHeap *h, int arity) {
+    if (*h->len == 0) return -1;
+    int top = h->heap[0];
+    h->pos[top] = -1;
+    if (--*h->len > 0) {
+        dheap_place(h, 0, h->heap[*h->len]);
+        dheap_down(h, 0, arity);
+    }
+    return top;
+}
+
+// The best-first steppers' heap: the SearchState's heap / heap_pos arrays,
+// keyed on s->fscore with ties to the larger s->dist
+static inline DHeap fheap_of(SearchState *s) {
+    return (DHeap){ s->heap, s->heap_pos, &s->heap_len, s->fscore, s->dist };
+}
+
+static inline void fheap_update(SearchState *s, int cell, int arity) {
+    DHeap h = fheap_of(s);
+    dheap_update(&h, cell, arity);
+}
+
+static inline int fheap_pop(SearchState *s, int arity) {
+    DHeap h = fheap_of(s);
+    return dheap_pop(&h, arity);
+}
@@ -0,0 +1,354 @@
+#pragma once
+#include "common.h"
+
+// Corridor-contracted junction graph. Every open cell whose degree is not 2
+// (junctions, dead ends, isolated cells) becomes a node; each run of degree-2
+// cells between two nodes becomes one weighted edge, and the run's cells are
+// kept so that a node path can be expanded back into cells. A ring with no
+// junction at all gets one of its cells promoted to a node.
+//
+// Queries may start or end inside a corridor: the start and goal then become
+// two extra virtual nodes linked to the ends of their corridors (or straight
+// to each other when they share one). Built once per maze, reused for any
+// number of queries; the cell grid itself is not copied.
+
+typedef enum {
+    JUNCTION_BFS,       // fewest nodes; shortest in cells only on perfect mazes
+    JUNCTION_DIJKSTRA,
+    JUNCTION_ASTAR,
+} JunctionAlgo;
+
+static const char *JUNCTION_ALGO_NAMES[] = { "BFS", "Dijkstra", "A*" };
+
+typedef struct {
+    int to;
+    int cost;        // entry costs of the corridor cells and of `to`
+    int corridor;    // -1 when the two nodes are adjacent cells
+    bool reverse;    // corridor cells are stored from the other end
+} JunctionEdge;
+
+typedef struct {
+    int first, len;  // into JunctionGraph.cells
+} JunctionCorridor;
+
+typedef qol_list(int) JunctionIntList;
+
+typedef struct {
+    int N;
+    const Grid *maze;
+    const CostGrid *costs;
+
+    int nodeCount;
+    int *nodeOf;     // N * N: node id of a cell, -1 for walls and corridor cells
+    JunctionIntList nodeCell;
+    int *edgeStart;  // edges of node n are edges[edgeStart[n] .. edgeStart[n + 1])
+    JunctionEdge *edges;
+    int edgeCount;
+    qol_list(JunctionCorridor) corridors;
+    JunctionIntList cells;
+
+    // Query scratch, nodeCount + 2 entries (virtual start and goal last)
+    int *dist;
+    int *parent;
+    int *via;        // CSR edge into the node, or JUNCTION_VIA_* for virtual links
+    uint8_t *done;
+    LazyHeap heap;         // Dijkstra and A*, keyed on dist (+ h)
+    JunctionIntList fifo;  // BFS
+} JunctionGraph;
+
+#define JUNCTION_VIA_START(k) (-2 - (k))   // k-th link out of the virtual start
+#define JUNCTION_VIA_GOAL(k) (-4 - (k))    // k-th link into the virtual goal
+
+static inline bool junction_open(const JunctionGraph *g, int x, int y) {
+    return x >= 0 && x < g->N && y >= 0 && y < g->N && grid_get(g->maze, x, y) == PATH;
+}
+
+static inline int junction_cost(const JunctionGraph *g, int idx) {
+    return g->costs ? g->costs->cost[idx] : 1;
+}
+
+// Follow the corridor leaving cell `from` in direction d until a node (or
+// `stop`, if >= 0) is entered. Returns the cell reached; *cost sums the entry
+// costs of every cell entered. Cells passed on the way are appended to out.
+static int junction_walk(const JunctionGraph *g, int from, int d, int stop, int *cost, JunctionIntList *out) {
+    int N = g->N;
+    int x = from % N, y = from / N;
+    *cost = 0;
+    while (true) {
+        x += dirs[d][0];
+        y += dirs[d][1];
+        int idx = y * N + x;
+        *cost += junction_cost(g, idx);
+        if (idx == stop || g->nodeOf[idx] >= 0) return idx;
+        if (out) qol_push(out, idx);
+        int back = (d + 2) & 3;
+        for (int i = 0; i < 4; i++) {
+            if (i != back && junction_open(g, x + dirs[i][0], y + dirs[i][1])) {
+                d = i;
+                break;
+            }
+        }
+    }
+}
+
+typedef struct {
+    int from;
+    JunctionEdge e;
+} JunctionRawEdge;
+
+typedef qol_list(JunctionRawEdge) JunctionRawEdges;
+
+// Walk every corridor leaving node a that has not been walked from its other end
+static void junction_link(JunctionGraph *g, int a, uint8_t *covered, JunctionRawEdges *raw) {
+    int N = g->N;
+    int cell = g->nodeCell.data[a];
+    int x = cell % N, y = cell / N;
+    for (int d = 0; d < 4; d++) {
+        int nx = x + dirs[d][0], ny = y + dirs[d][1];
+        if (!junction_open(g, nx, ny)) continue;
+        int next = ny * N + nx;
+        int b = g->nodeOf[next];
+        if (b >= 0) {
+            if (a < b) {
+                qol_push(raw, ((JunctionRawEdge){ a, { b, junction_cost(g, next), -1, false } }));
+                qol_push(raw, ((JunctionRawEdge){ b, { a, junction_cost(g, cell), -1, false } }));
+            }
+            continue;
+        }
+        if (covered[next]) continue;
+
+        int first = (int)g->cells.len;
+        int cost;
+        int end = junction_walk(g, cell, d, -1, &cost, &g->cells);
+        int len = (int)g->cells.len - first;
+        for (int i = first; i < first + len; i++) covered[g->cells.data[i]] = 1;
+        int c = (int)g->corridors.len;
+        qol_push(&g->corridors, ((JunctionCorridor){ first, len }));
+
+        b = g->nodeOf[end];
+        int interior = cost - junction_cost(g, end);
+        qol_push(raw, ((JunctionRawEdge){ a, { b, cost, c, false } }));
+        qol_push(raw, ((JunctionRawEdge){ b, { a, interior + junction_cost(g, cell), c, true } }));
+    }
+}
+
+static inline int junction_add_node(JunctionGraph *g, int cell) {
+    g->nodeOf[cell] = g->nodeCount;
+    qol_push(&g->nodeCell, cell);
+    return g->nodeCount++;
+}
+
+// Build the graph of maze (optionally weighted by costs, which must outlive
+// the graph)
+static void junction_build(JunctionGraph *g, const Grid *maze, const CostGrid *costs) {
+    memset(g, 0, sizeof(*g));
+    int N = maze->N;
+    g->N = N;
+    g->maze = maze;
+    g->costs = costs;
+    g->nodeOf = malloc((size_t)N * N * sizeof(int));
+    uint8_t *covered = calloc((size_t)N * N, 1);
+
+    for (int y = 0; y < N; y++) {
+        for (int x = 0; x < N; x++) {
+            int idx = y * N + x;
+            g->nodeOf[idx] = -1;
+            if (grid_get(maze, x, y) == WALL) continue;
+            int degree = 0;
+            for (int i = 0; i < 4; i++) degree += junction_open(g, x + dirs[i][0], y + dirs[i][1]);
+            if (degree != 2) junction_add_node(g, idx);
+        }
+    }
+
+    JunctionRawEdges raw = {0};
+    for (int a = 0; a < g->nodeCount; a++) junction_link(g, a, covered, &raw);
+    for (int y = 0; y < N; y++) {
+        for (int x = 0; x < N; x++) {
+            int idx = y * N + x;
+            if (grid_get(maze, x, y) == PATH && g->nodeOf[idx] < 0 && !covered[idx]) {
+                junction_link(g, junction_add_node(g, idx), covered, &raw);
+            }
+        }
+    }
+    free(covered);
+
+    // Counting sort into CSR
+    g->edgeCount = (int)raw.len;
+    g->edgeStart = calloc((size_t)g->nodeCount + 1, sizeof(int));
+    g->edges = malloc((raw.len ? raw.len : 1) * sizeof(JunctionEdge));
+    for (size_t i = 0; i < raw.len; i++) g->edgeStart[raw.data[i].from + 1]++;
+    for (int n = 0; n < g->nodeCount; n++) g->edgeStart[n + 1] += g->edgeStart[n];
+    int *fill = malloc(((size_t)g->nodeCount + 1) * sizeof(int));
+    memcpy(fill, g->edgeStart, ((size_t)g->nodeCount + 1) * sizeof(int));
+    for (size_t i = 0; i < raw.len; i++) g->edges[fill[raw.data[i].from]++] = raw.data[i].e;
+    free(fill);
+    qol_release(&raw);
+
+    size_t slots = (size_t)g->nodeCount + 2;
+    g->dist = malloc(slots * sizeof(int));
+    g->parent = malloc(slots * sizeof(int));
+    g->via = malloc(slots * sizeof(int));
+    g->done = malloc(slots);
+}
+
+static void junction_free(JunctionGraph *g) {
+    free(g->nodeOf);
+    free(g->edgeStart);
+    free(g->edges);
+    free(g->dist);
+    free(g->parent);
+    free(g->via);
+    free(g->done);
+    qol_release(&g->nodeCell);
+    qol_release(&g->corridors);
+    qol_release(&g->cells);
+    qol_release(&g->heap);
+    qol_release(&g->fifo);
+}
+
+// Links between a corridor endpoint (start or goal cell) and the nodes at the
+// ends of its corridor, or the other endpoint when both share the corridor
+typedef struct {
+    int count;
+    int dir[2];
+    int to[2];       // node id, or the virtual goal
+    int cost[2];
+} JunctionLinks;
+
+// Search from s->start to s->goal and fill s->path with the cells of the
+// result. Only the start, goal and path fields of s are used, so it does not
+// need search_init. Returns whether the goal is reachable; *expansions
+// counts the nodes settled.
+static bool junction_solve(JunctionGraph *g, SearchState *s, JunctionAlgo algo, long *expansions) {
+    int N = g->N;
+    int start = s->startY * N + s->startX;
+    int goal = s->goalY * N + s->goalX;
+    int S = g->nodeCount, G = g->nodeCount + 1;
+    int minCost = g->costs ? g->costs->min : 1;
+    *expansions = 0;
+    s->path.len = 0;
+    if (start == goal) {
+        qol_push(&s->path, ((Cell){ s->startX, s->startY }));
+        return true;
+    }
+
+    int src = g->nodeOf[start] >= 0 ? g->nodeOf[start] : S;
+    int dst = g->nodeOf[goal] >= 0 ? g->nodeOf[goal] : G;
+
+    JunctionLinks out = {0}, in = {0};
+    for (int d = 0; d < 4 && src == S; d++) {
+        if (!junction_open(g, s->startX + dirs[d][0], s->startY + dirs[d][1])) continue;
+        int cost;
+        int end = junction_walk(g, start, d, dst == G ? goal : -1, &cost, NULL);
+        out.dir[out.count] = d;
+        out.to[out.count] = end == goal && dst == G ? G : g->nodeOf[end];
+        out.cost[out.count++] = cost;
+    }
+    for (int d = 0; d < 4 && dst == G; d++) {
+        if (!junction_open(g, s->goalX + dirs[d][0], s->goalY + dirs[d][1])) continue;
+        int cost;
+        int end = junction_walk(g, goal, d, -1, &cost, NULL);
+        in.dir[in.count] = d;
+        in.to[in.count] = g->nodeOf[end];
+        in.cost[in.count++] = cost - junction_cost(g, end) + junction_cost(g, goal);
+    }
+
+    for (int n = 0; n < g->nodeCount + 2; n++) {
+        g->dist[n] = INF;
+        g->parent[n] = -1;
+        g->done[n] = 0;
+    }
+    g->heap.len = 0;
+    g->fifo.len = 0;
+    int gx = s->goalX, gy = s->goalY;
+    #define JUNCTION_H(n) (algo == JUNCTION_ASTAR && (n) < S ? \
+        (abs(g->nodeCell.data[n] % N - gx) + abs(g->nodeCell.data[n] / N - gy)) * minCost : 0)
+
+    // BFS shares the loop through a plain FIFO, the others through the lazy
+    // heap, whose stale entries the done check skips
+    bool bfs = algo == JUNCTION_BFS;
+    size_t head = 0;
+    g->dist[src] = 0;
+    if (bfs) qol_push(&g->fifo, src);
+    else lazy_push(&g->heap, src, 0);
+    bool found = src == dst;
+    while (!found && (bfs ? head < g->fifo.len : g->heap.len > 0)) {
+        int key;
+        int u = bfs ? g->fifo.data[head++] : lazy_pop(&g->heap, &key);
+        if (g->done[u]) continue;
+        g->done[u] = 1;
+        (*expansions)++;
+        if (u == dst) {
+            found = true;
+            break;
+        }
+
+        int count = u == S ? out.count : g->edgeStart[u + 1] - g->edgeStart[u];
+        int extra = u < S ? in.count : 0;
+        for (int k = 0; k < count + extra; k++) {
+            int v, w, via;
+            if (u == S) {
+                v = out.to[k];
+                w = out.cost[k];
+                via = JUNCTION_VIA_START(k);
+            } else if (k < count) {
+                const JunctionEdge *e = &g->edges[g->edgeStart[u] + k];
+                v = e->to;
+                w = e->cost;
+                via = g->edgeStart[u] + k;
+            } else {
+                if (in.to[k - count] != u) continue;
+                v = G;
+                w = in.cost[k - count];
+                via = JUNCTION_VIA_GOAL(k - count);
+            }
+            if (g->done[v]) continue;
+            int nd = bfs ? g->dist[u] + 1 : g->dist[u] + w;
+            if (nd >= g->dist[v]) continue;
+            g->dist[v] = nd;
+            g->parent[v] = u;
+            g->via[v] = via;
+            if (bfs) qol_push(&g->fifo, v);
+            else lazy_push(&g->heap, v, nd + JUNCTION_H(v));
+        }
+    }
+    #undef JUNCTION_H
+    if (!found) return false;
+
+    // Collect the hops back to front, then expand them front to back
+    JunctionIntList hops = {0};
+    for (int v = dst; v != src; v = g->parent[v]) qol_push(&hops, v);
+    JunctionIntList walk = {0};
+    qol_push(&s->path, ((Cell){ s->startX, s->startY }));
+    for (size_t h = hops.len; h-- > 0;) {
+        int v = hops.data[h];
+        int via = g->via[v];
+        walk.len = 0;
+        if (via >= 0) {
+            const JunctionEdge *e = &g->edges[via];
+            if (e->corridor >= 0) {
+                const JunctionCorridor *c = &g->corridors.data[e->corridor];
+                for (int i = 0; i < c->len; i++) {
+                    qol_push(&walk, g->cells.data[c->first + (e->reverse ? c->len - 1 - i : i)]);
+                }
+            }
+        } else if (via >= JUNCTION_VIA_START(1)) {
+            int cost;
+            junction_walk(g, start, out.dir[JUNCTION_VIA_START(0) - via], dst == G ? goal : -1, &cost, &walk);
+        } else {
+            int cost;
+            junction_walk(g, goal, in.dir[JUNCTION_VIA_GOAL(0) - via], -1, &cost, &walk);
+            for (size_t i = 0; i < walk.len / 2; i++) {
+                int t = walk.data[i];
+                walk.data[i] = walk.data[walk.len - 1 - i];
+                walk.data[walk.len - 1 - i] = t;
+            }
+        }
+        for (size_t i = 0; i < walk.len; i++) qol_push(&s->path, ((Cell){ walk.data[i] % N, walk.data[i] / N }));
+        int cell = v == G ? goal : g->nodeCell.data[v];
+        qol_push(&s->path, ((Cell){ cell % N, cell / N }));
+    }
+    qol_release(&walk);
+    qol_release(&hops);
+    return true;
+}
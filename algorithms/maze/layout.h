@@ -0,0 +1,105 @@
+#pragma once
+#include "../../libs/build.h"
+
+// Cell numbering shared by the per-cell search arrays and the neighbour
+// masks. Each search and mask set carries its layout; SEARCH_LAYOUT (see
+// maze.h) is the one search_init and neighbor_masks_init pick, and the
+// *_layout variants take another so the bench can run both in one build.
+// The wall Grid stays bit-packed row-major: generators, chunks and the maze
+// file format work on its 64-bit rows, and searches read the masks instead.
+//
+// LAYOUT_ROW: rows are 1 << shift >= N + 1 slots wide with a spare slot row
+// above and below, so cell (x, y) is ((y + 1) << shift) | x. Slots x >= N
+// double as the right border of their row and the left border of the next,
+// so every move is a fixed offset (+-1, +-stride) that stays in range.
+//
+// LAYOUT_MORTON: Z-order over the 1 << shift square holding the grid, x in
+// the even bits and y in the odd ones. A vertical neighbour is usually a few
+// cache lines away instead of a whole row, at the price of a masked add per
+// move. Slots outside the N x N grid are never touched.
+//
+// Both pad: a row layout spends (N + 2) * 2^ceil(log2(N + 1)) slots and a
+// Morton one 4^ceil(log2 N), so just above a power of two the search
+// arrays are about twice (row) or four times (Morton) N * N. N = 16385
+// gets a 32768-slot stride. Slot indexes are int, which caps N at 32767
+// for row and 32768 for Morton; see layout_fits().
+#define LAYOUT_ROW 0
+#define LAYOUT_MORTON 1
+#define LAYOUT_COUNT 2
+
+#ifndef SEARCH_LAYOUT
+#define SEARCH_LAYOUT LAYOUT_ROW
+#endif
+
+static const char *LAYOUT_NAMES[LAYOUT_COUNT] = { "row", "Morton" };
+#define LAYOUT_NAME LAYOUT_NAMES[SEARCH_LAYOUT]
+
+#define MORTON_X 0x55555555u
+#define MORTON_Y 0xaaaaaaaau
+
+static inline uint32_t morton_spread(uint32_t v) {
+    v &= 0xffff;
+    v = (v | v << 8) & 0x00ff00ff;
+    v = (v | v << 4) & 0x0f0f0f0f;
+    v = (v | v << 2) & 0x33333333;
+    v = (v | v << 1) & 0x55555555;
+    return v;
+}
+
+static inline uint32_t morton_compact(uint32_t v) {
+    v &= 0x55555555;
+    v = (v | v >> 1) & 0x33333333;
+    v = (v | v >> 2) & 0x0f0f0f0f;
+    v = (v | v >> 4) & 0x00ff00ff;
+    v = (v | v >> 8) & 0x0000ffff;
+    return v;
+}
+
+static inline int layout_shift(int layout, int N) {
+    size_t side = layout == LAYOUT_MORTON ? (size_t)N : (size_t)N + 1;
+    int shift = 0;
+    while (((size_t)1 << shift) < side) shift++;
+    return shift;
+}
+
+// Slots per array for an N x N grid
+static inline size_t layout_cells(int layout, int N) {
+    int shift = layout_shift(layout, N);
+    if (layout == LAYOUT_MORTON) return (size_t)1 << (2 * shift);
+    return (size_t)(N + 2) << shift;
+}
+
+// Whether every slot of an N x N grid has an int index
+static inline bool layout_fits(int layout, int N) {
+    return N > 0 && layout_cells(layout, N) <= (size_t)INT_MAX;
+}
+
+static inline int layout_index(int layout, int shift, int x, int y) {
+    if (layout == LAYOUT_MORTON) return (int)(morton_spread((uint32_t)x) | morton_spread((uint32_t)y) << 1);
+    return ((y + 1) << shift) | x;
+}
+
+static inline int layout_x(int layout, int shift, int i) {
+    if (layout == LAYOUT_MORTON) return (int)morton_compact((uint32_t)i);
+    return i & ((1 << shift) - 1);
+}
+
+static inline int layout_y(int layout, int shift, int i) {
+    if (layout == LAYOUT_MORTON) return (int)morton_compact((uint32_t)i >> 1);
+    return (i >> shift) - 1;
+}
+
+// Index of the neighbour of slot i in direction dirs[d]. The caller makes
+// sure the move stays inside the grid (the neighbour masks do).
+static inline int layout_move(int layout, int shift, int i, int d) {
+    if (layout == LAYOUT_MORTON) {
+        uint32_t u = (uint32_t)i;
+        switch (d) {
+        case 0:  return (int)((((u & MORTON_Y) - 2) & MORTON_Y) | (u & MORTON_X));
+        case 1:  return (int)((((u | MORTON_Y) + 1) & MORTON_X) | (u & MORTON_Y));
+        case 2:  return (int)((((u | MORTON_X) + 2) & MORTON_Y) | (u & MORTON_X));
+        default: return (int)((((u & MORTON_X) - 1) & MORTON_X) | (u & MORTON_Y));
+        }
+    }
+    return i + dirs[d][1] * (1 << shift) + dirs[d][0];
+}
@@ -0,0 +1,43 @@
+#pragma once
+#include "../../libs/build.h"
+
+// Binary min-heap of (key, slot) entries with lazy deletion: there is no
+// per-slot position array, so a slot whose key dropped is pushed again and
+// the caller skips the stale copy when it comes out (see pqueue.h). Each
+// entry is one 64-bit word, key in the high half and slot in the low half,
+// so entries compare with a single integer compare (equal keys to the lower
+// slot) and the heap stays one contiguous array.
+typedef qol_list(uint64_t) LazyHeap;
+
+static inline void lazy_push(LazyHeap *h, int slot, int key) {
+    uint64_t e = (uint64_t)(uint32_t)key << 32 | (uint32_t)slot;
+    qol_push(h, e);
+    size_t pos = h->len - 1;
+    while (pos > 0) {
+        size_t parent = (pos - 1) / 2;
+        if (h->data[parent] <= e) break;
+        h->data[pos] = h->data[parent];
+        pos = parent;
+    }
+    h->data[pos] = e;
+}
+
+// Remove the smallest entry; returns its slot (and key in *key), -1 when
+// empty
+static inline int lazy_pop(LazyHeap *h, int *key) {
+    if (h->len == 0) return -1;
+    uint64_t top = h->data[0];
+    uint64_t e = h->data[--h->len];
+    size_t pos = 0;
+    while (true) {
+        size_t child = 2 * pos + 1;
+        if (child >= h->len) break;
+        if (child + 1 < h->len && h->data[child + 1] < h->data[child]) child++;
+        if (h->data[child] >= e) break;
+        h->data[pos] = h->data[child];
+        pos = child;
+    }
+    if (h->len > 0) h->data[pos] = e;
+    *key = (int)(top >> 32);
+    return (int)(uint32_t)top;
+}
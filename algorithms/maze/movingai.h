@@ -0,0 +1,167 @@
+#pragma once
+#include "common.h"
+
+// Moving AI grid benchmark files (https://movingai.com/benchmarks/formats.html).
+//
+// A .map is a text header ("type octile", "height H", "width W", "map")
+// followed by H rows of W terrain characters. '.', 'G' and 'S' are passable
+// ground; everything else (trees, water, out of bounds) is a wall here. The
+// grid is square, so a W x H map is loaded into an N = max(W, H) grid whose
+// extra cells are walls.
+//
+// A .scen is "version 1" followed by one query per line:
+//   bucket map width height startX startY goalX goalY optimalLength
+// where optimalLength is the octile (8-connected, no corner cutting)
+// optimum. Our steppers are 4-connected, so their paths are never shorter.
+
+static bool movingai_passable(char c) {
+    return c == '.' || c == 'G' || c == 'S';
+}
+
+// Load a .map into g (square, side max(width, height)). Failures are warnings
+// rather than errors, so a scenario run can skip one bad map and go on.
+static bool movingai_load_map(const char *path, Grid *g, int *width, int *height) {
+    FILE *f = fopen(path, "r");
+    if (!f) {
+        qol_warn("Could not open %s\n", path);
+        return false;
+    }
+    char key[32];
+    int w = -1, h = -1;
+    while (fscanf(f, "%31s", key) == 1 && strcmp(key, "map") != 0) {
+        if (strcmp(key, "height") == 0 && fscanf(f, "%d", &h) != 1) h = -1;
+        else if (strcmp(key, "width") == 0 && fscanf(f, "%d", &w) != 1) w = -1;
+        else if (strcmp(key, "type") == 0 && fscanf(f, "%31s", key) != 1) break;
+    }
+    if (w <= 0 || h <= 0) {
+        qol_warn("%s: missing width/height\n", path);
+        fclose(f);
+        return false;
+    }
+
+    grid_init(g, w > h ? w : h);
+    grid_clear(g);
+    bool ok = true;
+    for (int y = 0; y < h && ok; y++) {
+        int x = 0;
+        while (x < w) {
+            int c = fgetc(f);
+            if (c == EOF) {
+                ok = false;
+                break;
+            }
+            if (c == '\n' || c == '\r') continue;
+            if (movingai_passable((char)c)) grid_set(g, x, y, PATH);
+            x++;
+        }
+    }
+    fclose(f);
+    if (!ok) {
+        qol_warn("%s: map data is truncated\n", path);
+        grid_free(g);
+        return false;
+    }
+    *width = w;
+    *height = h;
+    return true;
+}
+
+typedef struct {
+    char map[256];
+    int width, height;
+    int startX, startY, goalX, goalY;
+    double optimal;
+} MovingAiQuery;
+
+typedef qol_list(MovingAiQuery) MovingAiScen;
+
+static bool movingai_load_scen(const char *path, MovingAiScen *out) {
+    FILE *f = fopen(path, "r");
+    if (!f) {
+        qol_error("Could not open %s\n", path);
+        return false;
+    }
+    char line[1024];
+    int lineNo = 0;
+    while (fgets(line, sizeof(line), f)) {
+        lineNo++;
+        if (lineNo == 1 && strncmp(line, "version", 7) == 0) continue;
+        MovingAiQuery q;
+        int bucket;
+        int n = sscanf(line, "%d %255s %d %d %d %d %d %d %lf", &bucket, q.map, &q.width, &q.height,
+                       &q.startX, &q.startY, &q.goalX, &q.goalY, &q.optimal);
+        if (n == EOF || n <= 0) continue;
+        if (n != 9) {
+            qol_warn("%s:%d: malformed scenario, skipped\n", path, lineNo);
+            continue;
+        }
+        qol_push(out, q);
+    }
+    fclose(f);
+    return true;
+}
+
+// Scratch for movingai_grid_distance(), sized once per map
+typedef struct {
+    int *dist;       // N * N, -1 between queries
+    int *queue;      // N * N
+} MovingAiBfs;
+
+static void movingai_bfs_init(MovingAiBfs *b, int N) {
+    size_t cells = (size_t)N * N;
+    b->dist = malloc(cells * sizeof(int));
+    b->queue = malloc(cells * sizeof(int));
+    if (!b->dist || !b->queue) {
+        qol_error("Reference BFS out of memory (N = %d)\n", N);
+        abort();
+    }
+    for (size_t i = 0; i < cells; i++) b->dist[i] = -1;
+}
+
+static void movingai_bfs_free(MovingAiBfs *b) {
+    free(b->dist);
+    free(b->queue);
+    b->dist = b->queue = NULL;
+}
+
+// Shortest 4-connected path length in moves, or -1 when unreachable. Plain
+// BFS that shares nothing with the selected stepper, used as the reference
+// when checking its answers. Only the cells it reached are reset
+// afterwards, so a query costs what it explores, not N * N.
+static int movingai_grid_distance(const Grid *g, MovingAiBfs *b, int sx, int sy, int gx, int gy) {
+    int N = g->N;
+    int *dist = b->dist, *queue = b->queue;
+    int head = 0, tail = 0;
+    dist[sy * N + sx] = 0;
+    queue[tail++] = sy * N + sx;
+    int result = -1;
+    while (head < tail) {
+        int cur = queue[head++];
+        int x = cur % N, y = cur / N;
+        if (x == gx && y == gy) {
+            result = dist[cur];
+            break;
+        }
+        for (int i = 0; i < 4; i++) {
+            int nx = x + dirs[i][0], ny = y + dirs[i][1];
+            if (nx < 0 || nx >= N || ny < 0 || ny >= N || grid_get(g, nx, ny) == WALL) continue;
+            int idx = ny * N + nx;
+            if (dist[idx] >= 0) continue;
+            dist[idx] = dist[cur] + 1;
+            queue[tail++] = idx;
+        }
+    }
+    for (int i = 0; i < tail; i++) dist[queue[i]] = -1;
+    return result;
+}
+
+// Whether path is a chain of 4-adjacent open cells from (sx, sy) to (gx, gy)
+static bool movingai_path_valid(const Grid *g, const Cell *path, size_t len, int sx, int sy, int gx, int gy) {
+    if (len == 0 || path[0].x != sx || path[0].y != sy || path[len - 1].x != gx || path[len - 1].y != gy) return false;
+    for (size_t i = 0; i < len; i++) {
+        if (path[i].x < 0 || path[i].x >= g->N || path[i].y < 0 || path[i].y >= g->N) return false;
+        if (grid_get(g, path[i].x, path[i].y) == WALL) return false;
+        if (i > 0 && abs(path[i].x - path[i - 1].x) + abs(path[i].y - path[i - 1].y) != 1) return false;
+    }
+    return true;
+}
@@ -0,0 +1,72 @@
+#pragma once
+#include "grid.h"
+#include "layout.h"
+
+// Open-direction mask per cell: bit d is set when the neighbour in dirs[d]
+// is inside the grid and open. One byte per cell (the high nibble is
+// unused) in the cell layout of layout.h, the same one the search arrays
+// use, built once after generation so a search reads one byte per expansion
+// instead of bounds-checking and loading four walls. Slots outside the grid
+// stay 0 and no mask points into them. A cell's own wall bit is not part of
+// its mask.
+typedef struct {
+    int N;
+    int layout;      // LAYOUT_ROW or LAYOUT_MORTON
+    int shift;       // layout_shift(layout, N)
+    uint8_t *bits;
+} NeighborMasks;
+
+static inline void neighbor_masks_init_layout(NeighborMasks *m, int layout, int N) {
+    if (!layout_fits(layout, N)) {
+        qol_error("Neighbour masks for N = %d overflow int slot indexes\n", N);
+        abort();
+    }
+    m->N = N;
+    m->layout = layout;
+    m->shift = layout_shift(layout, N);
+    m->bits = calloc(layout_cells(layout, N), 1);
+    if (!m->bits) {
+        qol_error("Neighbour masks out of memory (N = %d)\n", N);
+        abort();
+    }
+}
+
+static inline void neighbor_masks_init(NeighborMasks *m, int N) {
+    neighbor_masks_init_layout(m, SEARCH_LAYOUT, N);
+}
+
+static inline void neighbor_masks_free(NeighborMasks *m) {
+    free(m->bits);
+    m->bits = NULL;
+}
+
+static inline uint8_t *neighbor_mask(const NeighborMasks *m, int x, int y) {
+    return &m->bits[layout_index(m->layout, m->shift, x, y)];
+}
+
+static inline uint8_t neighbor_mask_at(const Grid *maze, int x, int y) {
+    int N = maze->N;
+    uint8_t bits = 0;
+    for (int d = 0; d < 4; d++) {
+        int nx = x + dirs[d][0], ny = y + dirs[d][1];
+        if (nx >= 0 && nx < N && ny >= 0 && ny < N && grid_get(maze, nx, ny) == PATH) bits |= (uint8_t)(1 << d);
+    }
+    return bits;
+}
+
+// Fill the masks of an N x N maze
+static void neighbor_masks_build(NeighborMasks *m, const Grid *maze) {
+    int N = maze->N;
+    for (int y = 0; y < N; y++) {
+        for (int x = 0; x < N; x++) *neighbor_mask(m, x, y) = neighbor_mask_at(maze, x, y);
+    }
+}
+
+// Refresh the four neighbours of (x, y) after that cell was toggled
+static inline void neighbor_masks_update(NeighborMasks *m, const Grid *maze, int x, int y) {
+    int N = maze->N;
+    for (int d = 0; d < 4; d++) {
+        int nx = x + dirs[d][0], ny = y + dirs[d][1];
+        if (nx >= 0 && nx < N && ny >= 0 && ny < N) *neighbor_mask(m, nx, ny) = neighbor_mask_at(maze, nx, ny);
+    }
+}
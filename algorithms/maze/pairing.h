@@ -0,0 +1,131 @@
+#pragma once
+#include "../../libs/build.h"
+
+// Pairing heap over search slots with integer keys: a heap-ordered tree
+// kept as child / next-sibling links in per-slot arrays. Push and
+// decrease-key are O(1): the slot (cut from its parent on a decrease) is
+// melded with the root. Pop removes the root and pairs its children left
+// to right, then melds the pairs right to left, O(log n) amortised. prev is
+// the left sibling, or the parent for a first child, so a cut needs no
+// search.
+typedef struct {
+    int root;        // -1 when empty
+    int *child;      // per slot, first child or -1
+    int *next;       // per slot, right sibling or -1
+    int *prev;       // per slot, left sibling or parent, -1 at the root
+    int *key;        // per slot, its key while queued, -1 otherwise
+    int len;
+} PairingHeap;
+
+static inline void pairing_init(PairingHeap *h, int slots) {
+    h->child = malloc((size_t)slots * sizeof(int));
+    h->next = malloc((size_t)slots * sizeof(int));
+    h->prev = malloc((size_t)slots * sizeof(int));
+    h->key = malloc((size_t)slots * sizeof(int));
+    if (!h->child || !h->next || !h->prev || !h->key) {
+        qol_error("Pairing heap out of memory (%d slots)\n", slots);
+        abort();
+    }
+    for (int i = 0; i < slots; i++) h->key[i] = -1;
+    h->root = -1;
+    h->len = 0;
+}
+
+static inline void pairing_free(PairingHeap *h) {
+    free(h->child);
+    free(h->next);
+    free(h->prev);
+    free(h->key);
+    h->key = NULL;
+}
+
+// Make room for slots [old, slots) after the search gained slots
+static inline void pairing_grow(PairingHeap *h, int old, int slots) {
+    int *child = realloc(h->child, (size_t)slots * sizeof(int));
+    int *next = child ? realloc(h->next, (size_t)slots * sizeof(int)) : NULL;
+    int *prev = next ? realloc(h->prev, (size_t)slots * sizeof(int)) : NULL;
+    int *key = prev ? realloc(h->key, (size_t)slots * sizeof(int)) : NULL;
+    if (!key) {
+        qol_error("Pairing heap out of memory (%d slots)\n", slots);
+        abort();
+    }
+    h->child = child;
+    h->next = next;
+    h->prev = prev;
+    h->key = key;
+    for (int i = old; i < slots; i++) h->key[i] = -1;
+}
+
+// Join two trees; the root with the larger key becomes the first child of
+// the other. Overwrites the sibling links of both roots.
+static inline int pairing_meld(PairingHeap *h, int a, int b) {
+    if (h->key[b] < h->key[a]) {
+        int t = a;
+        a = b;
+        b = t;
+    }
+    h->next[b] = h->child[a];
+    if (h->child[a] >= 0) h->prev[h->child[a]] = b;
+    h->prev[b] = a;
+    h->child[a] = b;
+    h->next[a] = -1;
+    h->prev[a] = -1;
+    return a;
+}
+
+// Insert slot with key, or lower its key if it is queued already
+static inline void pairing_push(PairingHeap *h, int slot, int key) {
+    if (h->key[slot] >= 0) {
+        h->key[slot] = key;
+        if (slot == h->root) return;
+        int p = h->prev[slot];
+        if (h->child[p] == slot) h->child[p] = h->next[slot];
+        else h->next[p] = h->next[slot];
+        if (h->next[slot] >= 0) h->prev[h->next[slot]] = p;
+    } else {
+        h->key[slot] = key;
+        h->child[slot] = -1;
+        h->len++;
+    }
+    h->next[slot] = -1;
+    h->prev[slot] = -1;
+    h->root = h->root < 0 ? slot : pairing_meld(h, h->root, slot);
+}
+
+// Remove and return the slot with the smallest key, -1 when empty
+static inline int pairing_pop(PairingHeap *h) {
+    int top = h->root;
+    if (top < 0) return -1;
+    // First pass: meld neighbouring children, stacking the pairs through next
+    int pairs = -1;
+    int x = h->child[top];
+    while (x >= 0) {
+        int y = h->next[x];
+        if (y < 0) {
+            h->next[x] = pairs;
+            pairs = x;
+            break;
+        }
+        int rest = h->next[y];
+        int m = pairing_meld(h, x, y);
+        h->next[m] = pairs;
+        pairs = m;
+        x = rest;
+    }
+    // Second pass: meld the pairs from the last one back to the first
+    int root = pairs;
+    if (root >= 0) {
+        pairs = h->next[root];
+        h->next[root] = -1;
+        h->prev[root] = -1;
+        while (pairs >= 0) {
+            int rest = h->next[pairs];
+            root = pairing_meld(h, root, pairs);
+            pairs = rest;
+        }
+    }
+    h->root = root;
+    h->key[top] = -1;
+    h->len--;
+    return top;
+}
@@ -0,0 +1,104 @@
+#pragma once
+#include "common.h"
+#include "heap.h"
+
+// Open set of Dijkstra and A*, keyed on s->fscore and picked per search with
+// search_set_queue(). All of them give the same path costs; they differ in
+// how they order equal keys and in cost per operation:
+//
+// QUEUE_BINARY, QUEUE_QUAD, QUEUE_OCT: indexed d-ary heaps (heap.h) in
+//   heap / heap_pos, O(log n) push and pop, true decrease-key, equal keys
+//   to the larger g.
+// QUEUE_PAIRING: pairing heap (pairing.h), O(1) push and decrease-key,
+//   O(log n) amortised pop.
+// QUEUE_LAZY: binary heap of (key, slot) words (lazyheap.h) without
+//   heap_pos; a decreased key is pushed again and the stale copy dropped.
+// QUEUE_DIAL: Dial's ring of buckets (dial.h), O(1) push and decrease-key,
+//   pop walks at most the ring. The ring has room for the largest jump of a
+//   key in one relaxation: the highest cell cost (255 on terrain, 1
+//   otherwise) plus twice the cheapest cell for A*'s heuristic swing.
+// QUEUE_RADIX: radix heap (radix.h), O(1) push, pops amortised over the
+//   key's bits; a decreased key is pushed again and the stale copy dropped.
+//
+// The integer queues need monotone keys, which Dijkstra's g and A*'s f with
+// its consistent heuristic both are.
+
+static inline int search_queue_spread(const SearchState *s) {
+    return (s->costs ? 255 : 1) + 2 * search_min_cost(s);
+}
+
+// Queue slot with key s->fscore[slot], or move it there if it is queued
+static inline void search_queue_push(SearchState *s, int slot) {
+    s->pushes++;
+    if (s->trace) qol_push(s->trace, ((QueueOp){ QUEUE_OP_PUSH, slot, s->fscore[slot], s->dist[slot] }));
+    switch (s->queueKind) {
+    case QUEUE_QUAD:
+        fheap_update(s, slot, 4);
+        break;
+    case QUEUE_OCT:
+        fheap_update(s, slot, 8);
+        break;
+    case QUEUE_PAIRING:
+        if (!s->pairing.key) pairing_init(&s->pairing, s->max);
+        pairing_push(&s->pairing, slot, s->fscore[slot]);
+        break;
+    case QUEUE_LAZY:
+        lazy_push(&s->lazy, slot, s->fscore[slot]);
+        break;
+    case QUEUE_DIAL:
+        if (!s->dial.head) dial_init(&s->dial, search_queue_spread(s), s->max);
+        dial_push(&s->dial, slot, s->fscore[slot]);
+        break;
+    case QUEUE_RADIX:
+        radix_push(&s->radix, slot, (unsigned)s->fscore[slot]);
+        break;
+    default:
+        fheap_update(s, slot, 2);
+        break;
+    }
+}
+
+static inline int search_queue_take(SearchState *s) {
+    switch (s->queueKind) {
+    case QUEUE_QUAD:
+        s->pops++;
+        return fheap_pop(s, 4);
+    case QUEUE_OCT:
+        s->pops++;
+        return fheap_pop(s, 8);
+    case QUEUE_PAIRING:
+        if (!s->pairing.key) return -1;
+        s->pops++;
+        return pairing_pop(&s->pairing);
+    case QUEUE_LAZY:
+        while (true) {
+            int key;
+            int slot = lazy_pop(&s->lazy, &key);
+            if (slot < 0) return -1;
+            s->pops++;
+            if (key == s->fscore[slot] && !s->processed[slot]) return slot;
+        }
+    case QUEUE_DIAL:
+        if (!s->dial.head) return -1;
+        s->pops++;
+        return dial_pop(&s->dial);
+    case QUEUE_RADIX:
+        while (true) {
+            unsigned key;
+            int slot = radix_pop(&s->radix, &key);
+            if (slot < 0) return -1;
+            s->pops++;
+            if ((int)key == s->fscore[slot] && !s->processed[slot]) return slot;
+        }
+    default:
+        s->pops++;
+        return fheap_pop(s, 2);
+    }
+}
+
+// Remove and return the queued slot with the smallest key, -1 when empty
+static inline int search_queue_pop(SearchState *s) {
+    int slot = search_queue_take(s);
+    if (s->trace && slot >= 0) qol_push(s->trace, ((QueueOp){ QUEUE_OP_POP, slot, s->fscore[slot], s->dist[slot] }));
+    return slot;
+}
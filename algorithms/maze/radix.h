@@ -0,0 +1,64 @@
+#pragma once
+#include "../../libs/build.h"
+
+// Radix heap for monotone non-negative integer keys. Bucket 0 holds keys
+// equal to the last popped key `last`; bucket b > 0 holds keys whose highest
+// bit differing from last is bit b - 1. When bucket 0 runs dry the lowest
+// non-empty bucket is emptied: its minimum becomes the new last and every
+// entry falls into a strictly lower bucket, so each entry moves at most 32
+// times over its life and pops are O(log C) amortised for keys up to C.
+// There is no decrease-key: a cell whose key dropped is pushed again, and
+// the caller skips the stale copy when it comes out (see radix_pop).
+typedef struct {
+    unsigned key;
+    int slot;
+} RadixEntry;
+
+typedef qol_list(RadixEntry) RadixBucket;
+
+#define RADIX_BUCKETS 33
+
+typedef struct {
+    RadixBucket bucket[RADIX_BUCKETS];
+    unsigned last;
+    long len;        // entries, stale copies included
+} RadixHeap;
+
+static inline void radix_free(RadixHeap *h) {
+    for (int b = 0; b < RADIX_BUCKETS; b++) qol_release(&h->bucket[b]);
+    memset(h, 0, sizeof(*h));
+}
+
+static inline int radix_bucket(unsigned last, unsigned key) {
+    return key == last ? 0 : 32 - __builtin_clz(key ^ last);
+}
+
+// Key must not be below the last popped one
+static inline void radix_push(RadixHeap *h, int slot, unsigned key) {
+    qol_push(&h->bucket[radix_bucket(h->last, key)], ((RadixEntry){ key, slot }));
+    h->len++;
+}
+
+// Remove an entry with the smallest key; returns its slot (and key in *key),
+// -1 when empty
+static inline int radix_pop(RadixHeap *h, unsigned *key) {
+    if (h->len == 0) return -1;
+    if (h->bucket[0].len == 0) {
+        int b = 1;
+        while (h->bucket[b].len == 0) b++;
+        RadixBucket *from = &h->bucket[b];
+        unsigned min = from->data[0].key;
+        for (size_t i = 1; i < from->len; i++) {
+            if (from->data[i].key < min) min = from->data[i].key;
+        }
+        h->last = min;
+        for (size_t i = 0; i < from->len; i++) {
+            qol_push(&h->bucket[radix_bucket(min, from->data[i].key)], from->data[i]);
+        }
+        from->len = 0;
+    }
+    RadixEntry e = h->bucket[0].data[--h->bucket[0].len];
+    h->len--;
+    *key = e.key;
+    return e.slot;
+}
@@ -0,0 +1,183 @@
+#pragma once
+#include "grid.h"
+
+// Tree index for perfect mazes: the open cells form a spanning tree, so the
+// path between two cells is a -> lca(a, b) -> b. The tree is rooted at cell
+// (1, 1) and its Euler tour is kept with a range-minimum structure on depth:
+// a sparse table over blocks of 32 tour entries plus, for every entry, a
+// 32-bit mask of the in-block stack of prefix minima. Both parts answer in
+// O(1), so lca() and distance() are a handful of loads; path() writes the
+// cells in O(path length) into a buffer the caller owns and reuses.
+//
+// Cell ids are y * N + x. Memory is 12 bytes per cell plus about 16 bytes
+// per open cell. On a maze with loops the DFS tree is indexed instead and
+// distances are tree distances (perfect is false).
+#define TREE_BLOCK 32
+
+typedef struct {
+    int N;
+    int root;
+    bool perfect;
+    int *parent;     // per cell, -1 for the root, walls and unreachable cells
+    int *depth;
+    int *first;      // first Euler position of each cell, -1 if not in the tree
+    int *euler;      // cell at each tour position, 2V - 1 entries
+    uint32_t *mask;  // in-block stack of prefix minima ending at each position
+    int *table;      // levels * blocks, position of the shallowest entry
+    int blocks;
+    int levels;
+    int tourLen;
+} TreeIndex;
+
+static inline int tree_index_min(const TreeIndex *ti, int a, int b) {
+    return ti->depth[ti->euler[a]] <= ti->depth[ti->euler[b]] ? a : b;
+}
+
+// Shallowest tour position in [l, r], both inside one block
+static inline int tree_index_in_block(const TreeIndex *ti, int l, int r) {
+    uint32_t m = ti->mask[r] & (uint32_t)((2ull << (r - l)) - 1);
+    return r - (31 - __builtin_clz(m));
+}
+
+static void tree_index_build(TreeIndex *ti, const Grid *maze) {
+    int N = maze->N;
+    size_t cells = (size_t)N * N;
+    memset(ti, 0, sizeof(*ti));
+    ti->N = N;
+    ti->root = N + 1;
+    ti->parent = malloc(cells * sizeof(int));
+    ti->depth = malloc(cells * sizeof(int));
+    ti->first = malloc(cells * sizeof(int));
+    for (size_t i = 0; i < cells; i++) {
+        ti->parent[i] = -1;
+        ti->first[i] = -1;
+    }
+
+    // Iterative DFS; each frame is a cell and the next direction to try
+    qol_list(int) tour = {0};
+    qol_list(int) stack = {0};
+    long open = 0, treeEdges = 0, edges = 0;
+    for (int y = 0; y < N; y++) {
+        for (int x = 0; x < N; x++) {
+            if (grid_get(maze, x, y) == WALL) continue;
+            open++;
+            if (x + 1 < N && grid_get(maze, x + 1, y) == PATH) edges++;
+            if (y + 1 < N && grid_get(maze, x, y + 1) == PATH) edges++;
+        }
+    }
+    if (N > 2 && grid_get(maze, 1, 1) == PATH) {
+        ti->depth[ti->root] = 0;
+        ti->first[ti->root] = 0;
+        qol_push(&tour, ti->root);
+        qol_push(&stack, ti->root);
+        qol_push(&stack, 0);
+    }
+    while (stack.len > 0) {
+        int d = stack.data[stack.len - 1];
+        int c = stack.data[stack.len - 2];
+        if (d == 4) {
+            stack.len -= 2;
+            if (stack.len > 0) qol_push(&tour, stack.data[stack.len - 2]);
+            continue;
+        }
+        stack.data[stack.len - 1] = d + 1;
+        int nx = c % N + dirs[d][0], ny = c / N + dirs[d][1];
+        if (nx < 0 || nx >= N || ny < 0 || ny >= N || grid_get(maze, nx, ny) == WALL) continue;
+        int n = ny * N + nx;
+        if (ti->first[n] >= 0) continue;
+        ti->parent[n] = c;
+        ti->depth[n] = ti->depth[c] + 1;
+        ti->first[n] = (int)tour.len;
+        treeEdges++;
+        qol_push(&tour, n);
+        qol_push(&stack, n);
+        qol_push(&stack, 0);
+    }
+    qol_release(&stack);
+    ti->perfect = treeEdges == edges && treeEdges == open - 1;
+
+    ti->tourLen = (int)tour.len;
+    ti->euler = tour.data;  // keep the list's buffer
+    int len = ti->tourLen;
+    ti->mask = malloc((len ? (size_t)len : 1) * sizeof(uint32_t));
+    for (int r = 0; r < len; r++) {
+        uint32_t cur = r % TREE_BLOCK == 0 ? 0 : ti->mask[r - 1] << 1;
+        int dr = ti->depth[ti->euler[r]];
+        while (cur) {
+            int j = r - __builtin_ctz(cur);
+            if (ti->depth[ti->euler[j]] < dr) break;
+            cur &= cur - 1;
+        }
+        ti->mask[r] = cur | 1;
+    }
+
+    ti->blocks = (len + TREE_BLOCK - 1) / TREE_BLOCK;
+    ti->levels = 1;
+    while ((1 << ti->levels) <= ti->blocks) ti->levels++;
+    ti->table = malloc(((size_t)ti->levels * ti->blocks + 1) * sizeof(int));
+    for (int b = 0; b < ti->blocks; b++) {
+        int end = (b + 1) * TREE_BLOCK - 1;
+        if (end >= len) end = len - 1;
+        ti->table[b] = tree_index_in_block(ti, b * TREE_BLOCK, end);
+    }
+    for (int k = 1; k < ti->levels; k++) {
+        int *prev = ti->table + (size_t)(k - 1) * ti->blocks;
+        int *cur = ti->table + (size_t)k * ti->blocks;
+        for (int b = 0; b + (1 << k) <= ti->blocks; b++) {
+            cur[b] = tree_index_min(ti, prev[b], prev[b + (1 << (k - 1))]);
+        }
+    }
+}
+
+static void tree_index_free(TreeIndex *ti) {
+    free(ti->parent);
+    free(ti->depth);
+    free(ti->first);
+    free(ti->euler);
+    free(ti->mask);
+    free(ti->table);
+    memset(ti, 0, sizeof(*ti));
+}
+
+// Lowest common ancestor of cells a and b, or -1 if either is not in the tree
+static inline int tree_index_lca(const TreeIndex *ti, int a, int b) {
+    int l = ti->first[a], r = ti->first[b];
+    if (l < 0 || r < 0) return -1;
+    if (l > r) {
+        int t = l;
+        l = r;
+        r = t;
+    }
+    int bl = l / TREE_BLOCK, br = r / TREE_BLOCK;
+    if (bl == br) return ti->euler[tree_index_in_block(ti, l, r)];
+    int best = tree_index_min(ti, tree_index_in_block(ti, l, bl * TREE_BLOCK + TREE_BLOCK - 1),
+                              tree_index_in_block(ti, br * TREE_BLOCK, r));
+    if (br - bl > 1) {
+        int k = 31 - __builtin_clz((unsigned)(br - bl - 1));
+        const int *level = ti->table + (size_t)k * ti->blocks;
+        best = tree_index_min(ti, best, tree_index_min(ti, level[bl + 1], level[br - (1 << k)]));
+    }
+    return ti->euler[best];
+}
+
+// Path length in moves between cells a and b, or -1 if not connected
+static inline int tree_index_distance(const TreeIndex *ti, int a, int b) {
+    int c = tree_index_lca(ti, a, b);
+    if (c < 0) return -1;
+    return ti->depth[a] + ti->depth[b] - 2 * ti->depth[c];
+}
+
+// Write the cells from a to b (both included) into out, which must hold
+// tree_index_distance(a, b) + 1 entries. Returns the number written, 0 if
+// a and b are not connected.
+static int tree_index_path(const TreeIndex *ti, int a, int b, int *out) {
+    int c = tree_index_lca(ti, a, b);
+    if (c < 0) return 0;
+    int len = ti->depth[a] + ti->depth[b] - 2 * ti->depth[c] + 1;
+    int i = 0;
+    for (int v = a; v != c; v = ti->parent[v]) out[i++] = v;
+    out[i] = c;
+    int j = len - 1;
+    for (int v = b; v != c; v = ti->parent[v]) out[j--] = v;
+    return len;
+}
@@ -0,0 +1,1366 @@
+#pragma once
+#include <sys/resource.h>
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#endif
+#include "maze.h"
+#include "algorithms/maze/junction.h"
+#include "algorithms/maze/csr.h"
+#include "algorithms/maze/treeindex.h"
+#include "algorithms/maze/pqueue.h"
+#include "algorithms/maze/bfs.h"
+#include "algorithms/maze/dijkstra.h"
+
+#define BENCH_SEED 1234u
+#define BENCH_REC_STACK ((size_t)512 * 1024 * 1024)
+
+// Recursive reference for GenerateMaze: identical carving order and random
+// stream, but one C stack frame per carved cell. Only used to check and time
+// the iterative generator.
+static void GenerateMazeRecursive(Grid *maze, int x, int y, Rng *rng) {
+    grid_set(maze, x, y, PATH);
+    int cand[4];
+    int k;
+    while ((k = MazeCandidates(maze, x, y, 1, 1, maze->N - 2, maze->N - 2, cand)) > 0) {
+        int d = cand[k > 1 ? rng_below(rng, k) : 0];
+        grid_set(maze, x + dirs[d][0], y + dirs[d][1], PATH);
+        GenerateMazeRecursive(maze, x + dirs[d][0] * 2, y + dirs[d][1] * 2, rng);
+    }
+}
+
+static void *bench_recursive_thread(void *arg) {
+    Rng rng;
+    rng_seed(&rng, BENCH_SEED);
+    GenerateMazeRecursive((Grid *)arg, 1, 1, &rng);
+    return NULL;
+}
+
+// The reference needs one frame per cell on the deepest corridor, so run it
+// on a thread with a large stack instead of the default 8 MB one.
+static bool bench_run_recursive(Grid *maze) {
+    pthread_attr_t attr;
+    pthread_t th;
+    pthread_attr_init(&attr);
+    pthread_attr_setstacksize(&attr, BENCH_REC_STACK);
+    bool ok = pthread_create(&th, &attr, bench_recursive_thread, maze) == 0;
+    if (ok) pthread_join(th, NULL);
+    pthread_attr_destroy(&attr);
+    return ok;
+}
+
+static void bench_backtracker(void) {
+    const int sizes[] = { 255, 1023, 2047, 4095, 16383 };
+
+    qol_info("Backtracker, iterative vs recursive (cells/s, N x N grid)\n");
+    for (int i = 0; i < (int)QOL_ARRAY_LEN(sizes); i++) {
+        int N = sizes[i];
+        double cells = (double)N * N;
+        QOL_Timer t;
+
+        Grid a;
+        grid_init(&a, N);
+        grid_clear(&a);
+        Rng rng;
+        rng_seed(&rng, BENCH_SEED);
+        qol_timer_start(&t);
+        GenerateMaze(&a, 1, 1, &rng);
+        double iter = qol_timer_elapsed(&t);
+
+        if (N <= 2047) {
+            Grid b;
+            grid_init(&b, N);
+            grid_clear(&b);
+            qol_timer_start(&t);
+            bool ok = bench_run_recursive(&b);
+            double rec = qol_timer_elapsed(&t);
+            bool same = ok && memcmp(a.bits, b.bits, (size_t)a.stride * N * sizeof(uint64_t)) == 0;
+            qol_info("  N=%-6d iterative %8.2f Mcells/s  recursive %8.2f Mcells/s  %s\n",
+                     N, cells / iter / 1e6, cells / rec / 1e6, same ? "identical" : "MISMATCH");
+            grid_free(&b);
+        } else {
+            qol_info("  N=%-6d iterative %8.2f Mcells/s\n", N, cells / iter / 1e6);
+        }
+        grid_free(&a);
+    }
+}
+
+// A perfect maze over R x R rooms opens exactly R^2 rooms and R^2 - 1 walls
+static bool bench_is_perfect(const Grid *maze) {
+    long long rooms = (long long)(maze->N - 1) / 2;
+    long long open = 0;
+    for (int y = 0; y < maze->N; y++) {
+        const uint64_t *row = grid_row(maze, y);
+        for (int w = 0; w < maze->stride; w++) open += __builtin_popcountll(~row[w]);
+    }
+    return open == 2 * rooms * rooms - 1;
+}
+
+static void bench_tiled(void) {
+    const int sizes[] = { 4095, 16383 };
+    int cores = (int)sysconf(_SC_NPROCESSORS_ONLN);
+
+    qol_info("Tiled parallel generation (%d cores)\n", cores);
+    for (int i = 0; i < (int)QOL_ARRAY_LEN(sizes); i++) {
+        int N = sizes[i];
+        double cells = (double)N * N;
+        double base = 0.0;
+        Grid first = {0};
+
+        for (int threads = 1; threads <= cores; threads *= 2) {
+            Grid g;
+            grid_init(&g, N);
+            grid_clear(&g);
+            Rng rng;
+            rng_seed(&rng, BENCH_SEED);
+            QOL_Timer t;
+            qol_timer_start(&t);
+            GenerateMazeTiled(&g, &rng, threads);
+            double dt = qol_timer_elapsed(&t);
+            if (threads == 1) base = dt;
+
+            const char *check = "";
+            if (!first.bits) {
+                first = g;
+                check = bench_is_perfect(&g) ? "perfect" : "NOT PERFECT";
+            } else {
+                check = memcmp(first.bits, g.bits, (size_t)g.stride * N * sizeof(uint64_t)) == 0 ? "identical" : "MISMATCH";
+                grid_free(&g);
+            }
+            qol_info("  N=%-6d threads=%-3d %8.2f Mcells/s  speedup %5.2fx  %s\n",
+                     N, threads, cells / dt / 1e6, base / dt, check);
+        }
+        grid_free(&first);
+    }
+}
+
+// Generate one maze in a forked child, so the child's peak RSS can be read
+// back from wait4() without earlier runs inflating it. Returns false if the
+// child could not be run.
+static bool bench_generate_isolated(MazeGen gen, int N, double *seconds, double *peakMB) {
+    int fds[2];
+    if (pipe(fds) != 0) return false;
+    pid_t pid = fork();
+    if (pid < 0) {
+        close(fds[0]);
+        close(fds[1]);
+        return false;
+    }
+    if (pid == 0) {
+        close(fds[0]);
+        Grid g;
+        grid_init(&g, N);
+        grid_clear(&g);
+        Rng rng;
+        rng_seed(&rng, BENCH_SEED);
+        QOL_Timer t;
+        qol_timer_start(&t);
+        GenerateMazeWith(&g, gen, &rng);
+        double dt = qol_timer_elapsed(&t);
+        bool ok = !GenIsPerfect(gen) || bench_is_perfect(&g);
+        if (!ok) dt = -1.0;
+        ssize_t w = write(fds[1], &dt, sizeof(dt));
+        _exit(w == sizeof(dt) ? 0 : 1);
+    }
+    close(fds[1]);
+    double dt = -1.0;
+    bool ok = read(fds[0], &dt, sizeof(dt)) == sizeof(dt);
+    close(fds[0]);
+    int status = 0;
+    struct rusage ru;
+    if (wait4(pid, &status, 0, &ru) != pid || !WIFEXITED(status) || WEXITSTATUS(status) != 0) ok = false;
+#ifdef MACOS
+    *peakMB = (double)ru.ru_maxrss / (1024.0 * 1024.0); // bytes
+#else
+    *peakMB = (double)ru.ru_maxrss / 1024.0;            // kilobytes
+#endif
+    *seconds = dt;
+    return ok;
+}
+
+// Word-parallel binary-tree and sidewinder generators against the
+// backtracker on the same grid sizes, in one process (repeated until a
+// quarter second has passed, so the small sizes are not all timer noise)
+static void bench_bulk(void) {
+    const int sizes[] = { 1023, 4095, 16383 };
+    const MazeGen gens[] = { GEN_BACKTRACKER, GEN_BINARY_TREE, GEN_SIDEWINDER };
+
+    qol_info("Bulk generation (Mcells/s, N x N grid, speedup over the backtracker)\n");
+    for (int i = 0; i < (int)QOL_ARRAY_LEN(sizes); i++) {
+        int N = sizes[i];
+        Grid g;
+        grid_init(&g, N);
+        double base = 0.0;
+        for (int k = 0; k < (int)QOL_ARRAY_LEN(gens); k++) {
+            Rng rng;
+            rng_seed(&rng, BENCH_SEED);
+            int reps = 0;
+            double dt = 0.0;
+            bool perfect = true;
+            while (dt < 0.25) {
+                grid_clear(&g);
+                QOL_Timer t;
+                qol_timer_start(&t);
+                GenerateMazeWith(&g, gens[k], &rng);
+                dt += qol_timer_elapsed(&t);
+                reps++;
+                perfect &= bench_is_perfect(&g);
+            }
+            double rate = (double)N * N * reps / dt;
+            if (k == 0) base = rate;
+            qol_info("  N=%-6d %-12s %9.2f Mcells/s  %7.1fx  %s\n", N, GEN_NAMES[gens[k]], rate / 1e6, rate / base,
+                     perfect ? "perfect" : "NOT PERFECT");
+        }
+        grid_free(&g);
+    }
+}
+
+// Every generator across N: throughput and peak resident memory
+static void bench_generator_matrix(void) {
+    const int sizes[] = { 255, 1023, 4095, 8191 };
+
+    qol_info("Maze generators (cells/s and peak RSS per process, N x N grid)\n");
+    for (int gen = 0; gen < GEN_COUNT; gen++) {
+        for (int i = 0; i < (int)QOL_ARRAY_LEN(sizes); i++) {
+            int N = sizes[i];
+            double dt, peak;
+            if (!bench_generate_isolated(gen, N, &dt, &peak)) {
+                qol_error("  %-18s N=%-6d failed\n", GEN_NAMES[gen], N);
+                continue;
+            }
+            if (dt < 0) {
+                qol_error("  %-18s N=%-6d produced an imperfect maze\n", GEN_NAMES[gen], N);
+                continue;
+            }
+            qol_info("  %-18s N=%-6d %8.2f Mcells/s  %8.3fs  peak RSS %8.1f MB\n",
+                     GEN_NAMES[gen], N, (double)N * N / dt / 1e6, dt, peak);
+        }
+    }
+}
+
+// Selected grid stepper vs the corridor-contracted junction graph on the same
+// random queries: nodes expanded, solve time and agreement of path lengths
+static void bench_junction(void) {
+    const int sizes[] = { 255, 1023, 2047 };
+    const int queries = 16;
+
+    qol_info("Junction graph vs %s on the grid (%d queries per maze, backtracker mazes)\n", ALGO_NAME, queries);
+    for (int i = 0; i < (int)QOL_ARRAY_LEN(sizes); i++) {
+        int N = sizes[i];
+        Grid maze;
+        grid_init(&maze, N);
+        grid_clear(&maze);
+        Rng rng;
+        rng_seed(&rng, BENCH_SEED);
+        GenerateMaze(&maze, 1, 1, &rng);
+
+        QOL_Timer t;
+        qol_timer_start(&t);
+        JunctionGraph jg;
+        junction_build(&jg, &maze, NULL);
+        double build = qol_timer_elapsed(&t);
+        qol_info("  N=%-5d %d nodes, %d edges, built in %.3fs\n", N, jg.nodeCount, jg.edgeCount / 2, build);
+
+        long gridExp = 0, junctionExp[3] = {0};
+        double gridTime = 0.0, junctionTime[3] = {0};
+        int mismatches = 0;
+        for (int q = 0; q < queries; q++) {
+            int sx = 1 + 2 * (int)rng_below(&rng, (N - 1) / 2), sy = 1 + 2 * (int)rng_below(&rng, (N - 1) / 2);
+            int gx = 1 + 2 * (int)rng_below(&rng, (N - 1) / 2), gy = 1 + 2 * (int)rng_below(&rng, (N - 1) / 2);
+
+            SearchState s = {0};
+            search_init(&s, N, &maze, sx, sy, gx, gy, &rng);
+            long steps;
+            qol_timer_start(&t);
+            RunSearch(&s, &steps);
+            gridTime += qol_timer_elapsed(&t);
+            gridExp += steps;
+
+            SearchState js = { .N = N, .startX = sx, .startY = sy, .goalX = gx, .goalY = gy };
+            for (int a = 0; a < 3; a++) {
+                long exp;
+                qol_timer_start(&t);
+                junction_solve(&jg, &js, (JunctionAlgo)a, &exp);
+                junctionTime[a] += qol_timer_elapsed(&t);
+                junctionExp[a] += exp;
+                if (js.path.len != s.path.len) mismatches++;
+            }
+            qol_release(&js.path);
+            search_free(&s);
+        }
+
+        qol_info("    grid %-9s %10.1f expanded/query  %8.3f ms/query\n", ALGO_NAME, (double)gridExp / queries, gridTime * 1e3 / queries);
+        for (int a = 0; a < 3; a++) {
+            qol_info("    junction %-9s %6.1f expanded/query  %8.3f ms/query  %5.1fx fewer expansions\n",
+                     JUNCTION_ALGO_NAMES[a], (double)junctionExp[a] / queries, junctionTime[a] * 1e3 / queries,
+                     junctionExp[a] ? (double)gridExp / junctionExp[a] : 0.0);
+        }
+        if (mismatches) qol_error("    %d path lengths differ from the grid search\n", mismatches);
+        junction_free(&jg);
+        grid_free(&maze);
+    }
+}
+
+// Selected grid stepper vs CSR Dijkstra in each node order: solve time and
+// the memory taken by per-query search state
+static void bench_csr(void) {
+    const int sizes[] = { 1023, 2047, 4095 };
+    const int queries = 8;
+
+    qol_info("CSR adjacency vs %s on the grid (%d queries per maze, backtracker mazes)\n", ALGO_NAME, queries);
+    for (int i = 0; i < (int)QOL_ARRAY_LEN(sizes); i++) {
+        int N = sizes[i];
+        Grid maze;
+        grid_init(&maze, N);
+        grid_clear(&maze);
+        Rng rng;
+        rng_seed(&rng, BENCH_SEED);
+        GenerateMaze(&maze, 1, 1, &rng);
+
+        int qs[8][4];
+        for (int q = 0; q < queries; q++) {
+            for (int k = 0; k < 4; k++) qs[q][k] = 1 + 2 * (int)rng_below(&rng, (N - 1) / 2);
+        }
+
+        QOL_Timer t;
+        double gridTime = 0.0;
+        size_t gridLen[8];
+        for (int q = 0; q < queries; q++) {
+            SearchState s = {0};
+            search_init(&s, N, &maze, qs[q][0], qs[q][1], qs[q][2], qs[q][3], &rng);
+            long steps;
+            qol_timer_start(&t);
+            RunSearch(&s, &steps);
+            gridTime += qol_timer_elapsed(&t);
+            gridLen[q] = s.path.len;
+            search_free(&s);
+        }
+        double gridMB = 7.0 * sizeof(int) * N * N / (1024.0 * 1024.0);
+        qol_info("  N=%-5d grid %-9s %8.3f ms/query  state %7.1f MB\n", N, ALGO_NAME, gridTime * 1e3 / queries, gridMB);
+
+        for (int o = 0; o < CSR_ORDER_COUNT; o++) {
+            CsrGraph g;
+            qol_timer_start(&t);
+            csr_build(&g, &maze, NULL, (CsrOrder)o);
+            double build = qol_timer_elapsed(&t);
+            CsrSearch cs;
+            csr_search_init(&cs, &g);
+            double solve = 0.0;
+            int mismatches = 0;
+            for (int q = 0; q < queries; q++) {
+                SearchState s = { .N = N, .startX = qs[q][0], .startY = qs[q][1], .goalX = qs[q][2], .goalY = qs[q][3] };
+                int src = csr_node(&g, s.startX, s.startY), dst = csr_node(&g, s.goalX, s.goalY);
+                long exp;
+                qol_timer_start(&t);
+                csr_solve(&g, &cs, &s, src, dst, CSR_DIJKSTRA, &exp);
+                solve += qol_timer_elapsed(&t);
+                if (s.path.len != gridLen[q]) mismatches++;
+                qol_release(&s.path);
+            }
+            double stateMB = 5.0 * sizeof(int) * g.count / (1024.0 * 1024.0);
+            double graphMB = (4.0 * g.count + g.rowStart[g.count]) * sizeof(int) / (1024.0 * 1024.0);
+            qol_info("    CSR %-9s %8.3f ms/query  state %7.1f MB  graph %6.1f MB  mean id gap %8.1f  built in %.3fs%s\n",
+                     CSR_ORDER_NAMES[o], solve * 1e3 / queries, stateMB, graphMB, csr_mean_gap(&g), build,
+                     mismatches ? "  PATH MISMATCH" : "");
+            csr_search_free(&cs);
+            csr_free(&g);
+        }
+        grid_free(&maze);
+    }
+}
+
+// Whether two indexes partition the open cells the same way (ids may differ)
+static bool bench_same_components(const ComponentIndex *a, const ComponentIndex *b) {
+    size_t cells = (size_t)a->N * a->N;
+    size_t ids = a->size.len > b->size.len ? a->size.len : b->size.len;
+    int *ab = malloc(ids * sizeof(int)), *ba = malloc(ids * sizeof(int));
+    for (size_t i = 0; i < ids; i++) ab[i] = ba[i] = -1;
+    bool same = a->count == b->count;
+    for (size_t i = 0; i < cells && same; i++) {
+        int la = a->label[i], lb = b->label[i];
+        if ((la < 0) != (lb < 0)) same = false;
+        else if (la >= 0) {
+            if (ab[la] < 0 && ba[lb] < 0) {
+                ab[la] = lb;
+                ba[lb] = la;
+            }
+            same = ab[la] == lb && ba[lb] == la;
+        }
+    }
+    free(ab);
+    free(ba);
+    return same;
+}
+
+// Component index: parallel build, disconnected queries answered by the
+// index vs flooded by the selected stepper, and single-cell toggles checked
+// against a full rebuild
+static void bench_components(void) {
+    const int sizes[] = { 1023, 4095, 8191 };
+    int cores = (int)sysconf(_SC_NPROCESSORS_ONLN);
+
+    qol_info("Component index (%d cores, open fields with 45%% random walls)\n", cores);
+    for (int i = 0; i < (int)QOL_ARRAY_LEN(sizes); i++) {
+        int N = sizes[i];
+        Grid g;
+        grid_init(&g, N);
+        grid_clear(&g);
+        Rng rng;
+        rng_seed(&rng, BENCH_SEED);
+        for (int y = 0; y < N; y++) {
+            for (int x = 0; x < N; x++) {
+                if (rng_below(&rng, 100) >= 45) grid_set(&g, x, y, PATH);
+            }
+        }
+
+        ComponentIndex first = {0};
+        double base = 0.0;
+        for (int threads = 1; threads <= cores; threads *= 2) {
+            ComponentIndex ci;
+            QOL_Timer t;
+            qol_timer_start(&t);
+            components_build(&ci, &g, threads);
+            double dt = qol_timer_elapsed(&t);
+            if (threads == 1) base = dt;
+            const char *check = "";
+            if (!first.label) {
+                first = ci;
+            } else {
+                check = bench_same_components(&first, &ci) ? "identical" : "MISMATCH";
+                components_free(&ci);
+            }
+            qol_info("  N=%-5d threads=%-3d %8.2f Mcells/s  speedup %5.2fx  %d components  %s\n",
+                     N, threads, (double)N * N / dt / 1e6, base / dt, first.count, check);
+        }
+
+        // Start in the largest component, goal in any other
+        int big = 0;
+        for (int id = 1; id < (int)first.size.len; id++) {
+            if (first.size.data[id] > first.size.data[big]) big = id;
+        }
+        int sx = -1, sy = -1, gx = -1, gy = -1;
+        for (int c = 0; c < N * N && (sx < 0 || gx < 0); c++) {
+            if (first.label[c] == big && sx < 0) sx = c % N, sy = c / N;
+            if (first.label[c] >= 0 && first.label[c] != big && gx < 0) gx = c % N, gy = c / N;
+        }
+        if (N <= 4095 && sx >= 0 && gx >= 0) {
+            SearchState s = {0};
+            search_init(&s, N, &g, sx, sy, gx, gy, &rng);
+            long steps;
+            QOL_Timer t;
+            qol_timer_start(&t);
+            RunSearch(&s, &steps);
+            double flood = qol_timer_elapsed(&t);
+            qol_timer_start(&t);
+            bool connected = search_check_components(&s, &first);
+            double check = qol_timer_elapsed(&t);
+            long visited = 0;
+            for (int c = 0; c < s.max; c++) visited += s.visited[c] != 0;
+            qol_info("    disconnected query: %s visits %ld cells in %.3f ms, index answers in %.6f ms%s\n",
+                     ALGO_NAME, visited, flood * 1e3, check * 1e3, connected ? "  WRONG" : "");
+            search_free(&s);
+        }
+
+        if (N <= 1023) {
+            const int toggles = 20000;
+            QOL_Timer t;
+            qol_timer_start(&t);
+            for (int k = 0; k < toggles; k++) {
+                int x = (int)rng_below(&rng, N), y = (int)rng_below(&rng, N);
+                components_set(&first, &g, x, y, grid_get(&g, x, y) == WALL ? PATH : WALL);
+            }
+            double dt = qol_timer_elapsed(&t);
+            ComponentIndex rebuilt;
+            components_build(&rebuilt, &g, 0);
+            qol_info("    %d random toggles: %.2f us/toggle, %s a full rebuild\n", toggles, dt * 1e6 / toggles,
+                     bench_same_components(&first, &rebuilt) ? "matches" : "DOES NOT MATCH");
+            components_free(&rebuilt);
+        }
+        components_free(&first);
+        grid_free(&g);
+    }
+}
+
+// Tree index on perfect mazes: LCA distance and path queries per second,
+// spot-checked against the selected grid stepper
+static void bench_tree_index(void) {
+    const int sizes[] = { 1023, 4095 };
+    const int queries = 1000000;
+
+    qol_info("Tree index (Euler tour + block sparse table LCA, backtracker mazes)\n");
+    for (int i = 0; i < (int)QOL_ARRAY_LEN(sizes); i++) {
+        int N = sizes[i];
+        Grid maze;
+        grid_init(&maze, N);
+        grid_clear(&maze);
+        Rng rng;
+        rng_seed(&rng, BENCH_SEED);
+        GenerateMaze(&maze, 1, 1, &rng);
+
+        QOL_Timer t;
+        qol_timer_start(&t);
+        TreeIndex ti;
+        tree_index_build(&ti, &maze);
+        double build = qol_timer_elapsed(&t);
+
+        int R = (N - 1) / 2;
+        int *pairs = malloc((size_t)queries * 2 * sizeof(int));
+        for (int q = 0; q < 2 * queries; q++) {
+            int x = 1 + 2 * (int)rng_below(&rng, R), y = 1 + 2 * (int)rng_below(&rng, R);
+            pairs[q] = y * N + x;
+        }
+
+        qol_timer_start(&t);
+        long long total = 0;
+        for (int q = 0; q < queries; q++) total += tree_index_distance(&ti, pairs[2 * q], pairs[2 * q + 1]);
+        double distTime = qol_timer_elapsed(&t);
+
+        int *buf = malloc((size_t)N * N * sizeof(int));
+        const int pathQueries = queries / 100;
+        qol_timer_start(&t);
+        long long cells = 0;
+        for (int q = 0; q < pathQueries; q++) cells += tree_index_path(&ti, pairs[2 * q], pairs[2 * q + 1], buf);
+        double pathTime = qol_timer_elapsed(&t);
+
+        int mismatches = 0;
+        for (int q = 0; q < 8; q++) {
+            int a = pairs[2 * q], b = pairs[2 * q + 1];
+            SearchState s = {0};
+            search_init(&s, N, &maze, a % N, a / N, b % N, b / N, &rng);
+            long steps;
+            RunSearch(&s, &steps);
+            int len = tree_index_path(&ti, a, b, buf);
+            bool same = (int)s.path.len == len;
+            for (int k = 0; same && k < len; k++) same = s.path.data[k].y * N + s.path.data[k].x == buf[k];
+            if (!same) mismatches++;
+            search_free(&s);
+        }
+
+        qol_info("  N=%-5d built in %.3fs (%s), distance %7.2f Mq/s (mean %.0f moves), path %7.3f Mcells/s%s\n",
+                 N, build, ti.perfect ? "perfect" : "NOT PERFECT", queries / distTime / 1e6, (double)total / queries,
+                 cells / pathTime / 1e6, mismatches ? "  PATH MISMATCH" : "");
+        free(buf);
+        free(pairs);
+        tree_index_free(&ti);
+        grid_free(&maze);
+    }
+}
+
+static long bench_dead_ends(const Grid *maze) {
+    long count = 0;
+    for (int y = 1; y < maze->N - 1; y += 2) {
+        for (int x = 1; x < maze->N - 1; x += 2) {
+            int exits = 0;
+            for (int d = 0; d < 4; d++) exits += grid_get(maze, x + dirs[d][0], y + dirs[d][1]) == PATH;
+            count += exits == 1;
+        }
+    }
+    return count;
+}
+
+// Braiding pass: throughput up to 10k x 10k, dead ends removed and loops
+// added, then how far BFS / Dijkstra / A* drift apart once paths are no
+// longer unique
+static void bench_braid(void) {
+    const int sizes[] = { 1023, 4095, 10001 };
+
+    qol_info("Braiding (dead ends %.2f, loops %.2f)\n", BRAID_DEAD_ENDS, BRAID_LOOPS);
+    for (int i = 0; i < (int)QOL_ARRAY_LEN(sizes); i++) {
+        int N = sizes[i];
+        Grid maze;
+        grid_init(&maze, N);
+        grid_clear(&maze);
+        Rng rng;
+        rng_seed(&rng, BENCH_SEED);
+        GenerateMaze(&maze, 1, 1, &rng);
+        long before = bench_dead_ends(&maze);
+
+        QOL_Timer t;
+        qol_timer_start(&t);
+        BraidMaze(&maze, &rng, BRAID_DEAD_ENDS, BRAID_LOOPS);
+        double dt = qol_timer_elapsed(&t);
+
+        long rooms = (long)(N - 1) / 2;
+        long open = 0;
+        for (size_t w = 0; w < (size_t)maze.stride * N; w++) open += 64 - __builtin_popcountll(maze.bits[w]);
+        qol_info("  N=%-6d %8.2f Mcells/s  dead ends %ld -> %ld  cycles added %ld\n",
+                 N, (double)N * N / dt / 1e6, before, bench_dead_ends(&maze), open - (2 * rooms * rooms - 1));
+        grid_free(&maze);
+    }
+
+    const int N = 1023;
+    const int queries = 16;
+    qol_info("  CSR solvers on N=%d, %d corner-to-corner-ish queries (expanded/query, mean path len)\n", N, queries);
+    for (int braided = 0; braided < 2; braided++) {
+        Grid maze;
+        grid_init(&maze, N);
+        grid_clear(&maze);
+        Rng rng;
+        rng_seed(&rng, BENCH_SEED);
+        GenerateMazeWith(&maze, braided ? GEN_BRAIDED : GEN_BACKTRACKER, &rng);
+        CsrGraph g;
+        csr_build(&g, &maze, NULL, CSR_ORDER_RCM);
+        CsrSearch cs;
+        csr_search_init(&cs, &g);
+        const char *names[] = { "BFS", "Dijkstra", "A*" };
+        for (int a = 0; a < 3; a++) {
+            Rng q = rng;
+            long exp = 0, len = 0;
+            for (int k = 0; k < queries; k++) {
+                SearchState s = { .N = N };
+                s.startX = 1 + 2 * (int)rng_below(&q, 64);
+                s.startY = 1 + 2 * (int)rng_below(&q, 64);
+                s.goalX = N - 2 - 2 * (int)rng_below(&q, 64);
+                s.goalY = N - 2 - 2 * (int)rng_below(&q, 64);
+                long e;
+                csr_solve(&g, &cs, &s, csr_node(&g, s.startX, s.startY), csr_node(&g, s.goalX, s.goalY), (CsrAlgo)a, &e);
+                exp += e;
+                len += (long)s.path.len;
+                qol_release(&s.path);
+            }
+            qol_info("    %-8s %-9s %10.1f expanded  %8.1f len\n", braided ? "braided" : "perfect", names[a],
+                     (double)exp / queries, (double)len / queries);
+        }
+        csr_search_free(&cs);
+        csr_free(&g);
+        grid_free(&maze);
+    }
+}
+
+// Hardware cache-miss counter of the calling thread. fd is -1 where perf
+// events are unavailable (not Linux, no PMU in a VM, perf_event_paranoid).
+typedef struct {
+    int fd;
+    long long count;
+} BenchCounter;
+
+static void bench_counter_open(BenchCounter *c) {
+    c->fd = -1;
+    c->count = 0;
+#ifdef __linux__
+    struct perf_event_attr attr;
+    memset(&attr, 0, sizeof(attr));
+    attr.type = PERF_TYPE_HARDWARE;
+    attr.size = sizeof(attr);
+    attr.config = PERF_COUNT_HW_CACHE_MISSES;
+    attr.disabled = 1;
+    attr.exclude_kernel = 1;
+    attr.exclude_hv = 1;
+    c->fd = (int)syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0);
+#endif
+}
+
+static void bench_counter_close(BenchCounter *c) {
+    if (c->fd >= 0) close(c->fd);
+    c->fd = -1;
+}
+
+static void bench_counter_start(BenchCounter *c) {
+#ifdef __linux__
+    if (c->fd < 0) return;
+    ioctl(c->fd, PERF_EVENT_IOC_RESET, 0);
+    ioctl(c->fd, PERF_EVENT_IOC_ENABLE, 0);
+#else
+    QOL_UNUSED(c);
+#endif
+}
+
+// Stop counting and add the events since bench_counter_start() to count
+static void bench_counter_stop(BenchCounter *c) {
+#ifdef __linux__
+    if (c->fd < 0) return;
+    ioctl(c->fd, PERF_EVENT_IOC_DISABLE, 0);
+    long long v = 0;
+    if (read(c->fd, &v, sizeof(v)) == (ssize_t)sizeof(v)) c->count += v;
+#else
+    QOL_UNUSED(c);
+#endif
+}
+
+static bool bench_selected_step(SearchState *s) {
+    return step(s);
+}
+
+// Steps of stepFn from (1, 1) towards (N - 2, N - 2), stopping at the goal,
+// after limit steps, or (limit < 0) after about budget seconds. The search
+// uses the layout of masks, SEARCH_LAYOUT without them. Returns the steps
+// taken and adds the time to *elapsed; misses, if given, counts over the
+// same stretch.
+static long bench_steps(const Grid *maze, const NeighborMasks *masks, bool (*stepFn)(SearchState *), long limit, double budget,
+                        double *elapsed, BenchCounter *misses) {
+    int N = maze->N;
+    Rng rng;
+    rng_seed(&rng, BENCH_SEED);
+    SearchState s = {0};
+    search_init_layout(&s, masks ? masks->layout : SEARCH_LAYOUT, N, maze, 1, 1, N - 2, N - 2, &rng);
+    search_set_masks(&s, masks);
+    QOL_Timer t;
+    if (misses) bench_counter_start(misses);
+    qol_timer_start(&t);
+    long steps = 0;
+    while (limit < 0 || steps < limit) {
+        steps++;
+        if (stepFn(&s)) break;
+        if (limit < 0 && (steps & 63) == 0 && qol_timer_elapsed(&t) > budget) break;
+    }
+    *elapsed += qol_timer_elapsed(&t);
+    if (misses) bench_counter_stop(misses);
+    search_free(&s);
+    return steps;
+}
+
+// Selected stepper with per-step bounds and wall checks vs precomputed
+// neighbour masks, over the same number of steps
+static void bench_neighbor_masks(void) {
+    const int sizes[] = { 511, 2047, 4095 };
+
+    qol_info("%s expansions, wall checks vs neighbour masks (ksteps/s)\n", ALGO_NAME);
+    for (int braided = 0; braided < 2; braided++) {
+        for (int i = 0; i < (int)QOL_ARRAY_LEN(sizes); i++) {
+            int N = sizes[i];
+            Grid maze;
+            grid_init(&maze, N);
+            grid_clear(&maze);
+            Rng rng;
+            rng_seed(&rng, BENCH_SEED);
+            GenerateMazeWith(&maze, braided ? GEN_BRAIDED : GEN_BACKTRACKER, &rng);
+
+            QOL_Timer t;
+            qol_timer_start(&t);
+            NeighborMasks masks;
+            neighbor_masks_init(&masks, N);
+            neighbor_masks_build(&masks, &maze);
+            double build = qol_timer_elapsed(&t);
+
+            double plain = 0.0, masked = 0.0;
+            long steps = bench_steps(&maze, NULL, bench_selected_step, -1, 2.0, &plain, NULL);
+            long same = bench_steps(&maze, &masks, bench_selected_step, steps, 0.0, &masked, NULL);
+            qol_info("  %-8s N=%-5d %9ld steps  checks %9.1f  masks %9.1f  %5.2fx  (masks built in %.3fs)%s\n",
+                     braided ? "braided" : "perfect", N, steps, steps / plain / 1e3, same / masked / 1e3,
+                     plain / masked, build, same == steps ? "" : "  MISMATCH");
+            neighbor_masks_free(&masks);
+            grid_free(&maze);
+        }
+    }
+}
+
+// Share of moves between open neighbours whose int slots fall on different
+// 64-byte lines and different 4 KB pages under the cell layout of masks
+static void bench_layout_locality(const NeighborMasks *masks, double *lines, double *pages) {
+    int N = masks->N;
+    long moves = 0, lineCross = 0, pageCross = 0;
+    for (int y = 0; y < N; y++) {
+        for (int x = 0; x < N; x++) {
+            int i = layout_index(masks->layout, masks->shift, x, y);
+            for (int d = 0; d < 4; d++) {
+                if (!(masks->bits[i] & (1 << d))) continue;
+                size_t a = (size_t)i * sizeof(int), b = (size_t)layout_move(masks->layout, masks->shift, i, d) * sizeof(int);
+                moves++;
+                lineCross += a / 64 != b / 64;
+                pageCross += a / 4096 != b / 4096;
+            }
+        }
+    }
+    *lines = moves ? (double)lineCross / moves : 0.0;
+    *pages = moves ? (double)pageCross / moves : 0.0;
+}
+
+// BFS and Dijkstra under the row and the Morton cell layout on large braided
+// mazes, corner to corner. Each stepper runs in the row layout for up to
+// budget seconds, then for the same number of steps in the Morton one, so
+// time and cache misses per step compare directly; the deltas are Morton
+// relative to row.
+static void bench_layout(void) {
+    const int sizes[] = { 2047, 4095, 8191, 16383, 32767 };
+    const double budget = 30.0;
+    const char *names[] = { "BFS", "Dijkstra" };
+    bool (*steppers[])(SearchState *) = { bfs_step, dijkstra_step };
+
+    double phys = (double)sysconf(_SC_PHYS_PAGES) * (double)sysconf(_SC_PAGESIZE);
+    BenchCounter misses;
+    bench_counter_open(&misses);
+    qol_info("Row vs Morton cell layout, braided mazes (cache misses: %s)\n",
+             misses.fd >= 0 ? "hardware counter" : "unavailable here");
+    for (int i = 0; i < (int)QOL_ARRAY_LEN(sizes); i++) {
+        int N = sizes[i];
+        // Seven int arrays and the masks per slot of the larger layout, the
+        // BFS queue, the grid; one layout is allocated at a time
+        size_t rowSlots = layout_cells(LAYOUT_ROW, N), mortonSlots = layout_cells(LAYOUT_MORTON, N);
+        double need = (double)(rowSlots > mortonSlots ? rowSlots : mortonSlots) * (7 * sizeof(int) + 1) + (double)N * N * (sizeof(Cell) / 2.0 + 1.0 / 8);
+        if (phys > 0 && need > 0.8 * phys) {
+            qol_info("  N=%-6d skipped, needs about %.1f GB of %.1f GB\n", N, need / 1e9, phys / 1e9);
+            continue;
+        }
+        Grid maze;
+        grid_init(&maze, N);
+        grid_clear(&maze);
+        Rng rng;
+        rng_seed(&rng, BENCH_SEED);
+        GenerateMazeWith(&maze, GEN_BRAIDED, &rng);
+
+        for (int a = 0; a < (int)QOL_ARRAY_LEN(steppers); a++) {
+            double dt[LAYOUT_COUNT] = {0}, lines[LAYOUT_COUNT], pages[LAYOUT_COUNT];
+            long long missCount[LAYOUT_COUNT];
+            long steps = -1;
+            bool same = true;
+            for (int l = 0; l < LAYOUT_COUNT; l++) {
+                NeighborMasks masks;
+                neighbor_masks_init_layout(&masks, l, N);
+                neighbor_masks_build(&masks, &maze);
+                bench_layout_locality(&masks, &lines[l], &pages[l]);
+                misses.count = 0;
+                long n = bench_steps(&maze, &masks, steppers[a], steps, budget, &dt[l], &misses);
+                if (steps < 0) steps = n;
+                else same = same && n == steps;
+                missCount[l] = misses.count;
+                neighbor_masks_free(&masks);
+            }
+
+            char missText[LAYOUT_COUNT][16], missDelta[16] = "n/a";
+            for (int l = 0; l < LAYOUT_COUNT; l++) {
+                snprintf(missText[l], sizeof(missText[l]), "n/a");
+                if (misses.fd >= 0) snprintf(missText[l], sizeof(missText[l]), "%.2f", (double)missCount[l] / steps);
+            }
+            if (misses.fd >= 0 && missCount[LAYOUT_ROW] > 0) {
+                snprintf(missDelta, sizeof(missDelta), "%+.1f%%", 100.0 * ((double)missCount[LAYOUT_MORTON] / missCount[LAYOUT_ROW] - 1.0));
+            }
+            qol_info("  N=%-6d %-8s %10ld steps  row %7.1f ns/step %6s misses/step  Morton %7.1f ns/step %6s misses/step"
+                     "  time %+6.1f%%  misses %7s  moves across lines %4.1f%% -> %4.1f%%, pages %4.1f%% -> %4.1f%%%s\n",
+                     N, names[a], steps, dt[LAYOUT_ROW] * 1e9 / steps, missText[LAYOUT_ROW], dt[LAYOUT_MORTON] * 1e9 / steps,
+                     missText[LAYOUT_MORTON], 100.0 * (dt[LAYOUT_MORTON] / dt[LAYOUT_ROW] - 1.0), missDelta,
+                     lines[LAYOUT_ROW] * 100.0, lines[LAYOUT_MORTON] * 100.0, pages[LAYOUT_ROW] * 100.0,
+                     pages[LAYOUT_MORTON] * 100.0, same ? "" : "  STEP MISMATCH");
+        }
+        grid_free(&maze);
+    }
+    bench_counter_close(&misses);
+}
+
+// RunSearch() that gives up once t has run for budget seconds
+static bool bench_dynamic_solve(SearchState *s, QOL_Timer *t, double budget, bool *timedOut) {
+    if (s->unreachable) return false;
+    for (long steps = 1; steps <= (long)s->max + 1; steps++) {
+        if (step(s)) return true;
+        if ((steps & 63) == 0 && qol_timer_elapsed(t) > budget) {
+            *timedOut = true;
+            return false;
+        }
+    }
+    return false;
+}
+
+// Open or close `toggles` random cells of maze one at a time with a search
+// from (1, 1) to the opposite corner kept solved, stopping after `budget`
+// seconds. incremental repairs the component index and restarts the search
+// only when dynamic_set() says so; otherwise every edit rebuilds the index
+// and the masks and solves from scratch. Returns the edits done, -1 if the
+// first solve alone takes the whole budget; *restarts counts fresh searches
+// and *wrong the edits after which the search disagreed with the index on
+// whether the goal is reachable.
+static int bench_dynamic_run(Grid *maze, const int *cells, int toggles, bool incremental, double budget,
+                             double *elapsed, int *restarts, int *wrong) {
+    int N = maze->N;
+    Rng rng;
+    rng_seed(&rng, BENCH_SEED);
+    NeighborMasks masks;
+    neighbor_masks_init(&masks, N);
+    neighbor_masks_build(&masks, maze);
+    ComponentIndex ci;
+    components_build(&ci, maze, 1);
+    SearchState s = {0};
+    search_init(&s, N, maze, 1, 1, N - 2, N - 2, &rng);
+    search_set_masks(&s, &masks);
+    search_check_components(&s, &ci);
+    *restarts = 0;
+    *wrong = 0;
+    QOL_Timer t;
+    qol_timer_start(&t);
+    bool timedOut = false;
+    bool found = bench_dynamic_solve(&s, &t, budget, &timedOut);
+    int done = timedOut ? -1 : 0;
+
+    qol_timer_start(&t);
+    for (; done >= 0 && done < toggles && !timedOut; done++) {
+        int x = cells[2 * done], y = cells[2 * done + 1];
+        int v = grid_get(maze, x, y) == WALL ? PATH : WALL;
+        bool restart = true;
+        if (incremental) {
+            restart = dynamic_set(maze, &masks, &ci, &s, x, y, v);
+        } else {
+            grid_set(maze, x, y, v);
+            components_free(&ci);
+            components_build(&ci, maze, 1);
+            neighbor_masks_build(&masks, maze);
+        }
+        if (restart) {
+            search_free(&s);
+            s = (SearchState){0};
+            search_init(&s, N, maze, 1, 1, N - 2, N - 2, &rng);
+            search_set_masks(&s, &masks);
+            search_check_components(&s, &ci);
+            found = false;
+        }
+        if (!found) found = bench_dynamic_solve(&s, &t, budget, &timedOut);
+        if (timedOut) break;
+        *restarts += restart;
+        *wrong += found != components_connected(&ci, 1, 1, N - 2, N - 2);
+    }
+    *elapsed = qol_timer_elapsed(&t);
+
+    search_free(&s);
+    components_free(&ci);
+    neighbor_masks_free(&masks);
+    return done;
+}
+
+// Runtime wall edits on braided mazes: incremental connectivity and search
+// invalidation against rebuilding and re-solving after every edit
+static void bench_dynamic(void) {
+    const int sizes[] = { 255, 1023 };
+    const int toggles = 2000;
+    const double budget = 10.0;
+
+    qol_info("Dynamic walls (%s, braided mazes, corner to corner, %d random toggles or %.0fs)\n", ALGO_NAME, toggles, budget);
+    for (int i = 0; i < (int)QOL_ARRAY_LEN(sizes); i++) {
+        int N = sizes[i];
+        Grid maze, copy;
+        grid_init(&maze, N);
+        grid_clear(&maze);
+        grid_init(&copy, N);
+        Rng rng;
+        rng_seed(&rng, BENCH_SEED);
+        GenerateMazeWith(&maze, GEN_BRAIDED, &rng);
+        size_t bytes = (size_t)maze.stride * N * sizeof(uint64_t);
+        memcpy(copy.bits, maze.bits, bytes);
+
+        int *cells = malloc((size_t)toggles * 2 * sizeof(int));
+        for (int k = 0; k < toggles; k++) {
+            do {
+                cells[2 * k] = 1 + (int)rng_below(&rng, N - 2);
+                cells[2 * k + 1] = 1 + (int)rng_below(&rng, N - 2);
+            } while ((cells[2 * k] == 1 && cells[2 * k + 1] == 1) || (cells[2 * k] == N - 2 && cells[2 * k + 1] == N - 2));
+        }
+
+        for (int incremental = 1; incremental >= 0; incremental--) {
+            double dt;
+            int restarts, wrong;
+            int done = bench_dynamic_run(incremental ? &maze : &copy, cells, toggles, incremental, budget, &dt, &restarts, &wrong);
+            if (done < 0) {
+                qol_info("  N=%-5d %-11s skipped, one solve takes over %.0fs\n", N, incremental ? "incremental" : "rebuild", budget);
+                continue;
+            }
+            qol_info("  N=%-5d %-11s %5d edits %10.1f us/edit  %5.1f%% restarted the search%s\n",
+                     N, incremental ? "incremental" : "rebuild", done, dt * 1e6 / (done ? done : 1),
+                     100.0 * restarts / (done ? done : 1), wrong ? "  REACHABILITY MISMATCH" : "");
+        }
+        free(cells);
+        grid_free(&copy);
+        grid_free(&maze);
+    }
+}
+
+// A* as it was before the indexed heap: a scan of every slot per step for
+// the open cell with the smallest f, ties to the lowest slot. Kept as the
+// baseline for bench_astar().
+static bool bench_astar_scan_step(SearchState *s) {
+    if (s->unreachable) return false;
+    int bestIdx = -1;
+    int bestScore = INF;
+    int minCost = search_min_cost(s);
+    for (int i = 0; i < s->max; i++) {
+        if (s->visited[i] && !s->processed[i]) {
+            int h = (abs(search_x(s, i) - s->goalX) + abs(search_y(s, i) - s->goalY)) * minCost;
+            int score = s->dist[i] + h;
+            if (score < bestScore) {
+                bestScore = score;
+                bestIdx = i;
+            }
+        }
+    }
+    if (bestIdx == -1) return false;
+
+    int x = search_x(s, bestIdx);
+    int y = search_y(s, bestIdx);
+    s->processed[bestIdx] = 1;
+
+    if (x == s->goalX && y == s->goalY) {
+        build_path(s);
+        return true;
+    }
+
+    for (unsigned m = search_neighbors(s, bestIdx); m; m &= m - 1) {
+        int idx = search_move(s, bestIdx, __builtin_ctz(m));
+        int nd = s->dist[bestIdx] + search_cost(s, idx);
+        if (nd < s->dist[idx]) {
+            s->dist[idx] = nd;
+            s->parent[idx] = bestIdx;
+            s->visited[idx] = 1;
+        }
+    }
+    return false;
+}
+
+// Corner-to-corner search on maze with stepFn until it finds the goal, runs
+// dry or budget seconds pass. Returns whether it finished; *steps counts
+// the steps taken and *cost is the path cost, -1 without a path.
+static bool bench_search_with(const Grid *maze, const NeighborMasks *masks, const CostGrid *costs, bool (*stepFn)(SearchState *),
+                              double budget, double *elapsed, long *steps, long *cost) {
+    int N = maze->N;
+    Rng rng;
+    rng_seed(&rng, BENCH_SEED);
+    SearchState s = {0};
+    search_init(&s, N, maze, 1, 1, N - 2, N - 2, &rng);
+    search_set_costs(&s, costs);
+    search_set_masks(&s, masks);
+    QOL_Timer t;
+    qol_timer_start(&t);
+    bool finished = false, found = false;
+    for (*steps = 1; *steps <= (long)s.max + 1; (*steps)++) {
+        if (stepFn(&s)) {
+            finished = found = true;
+            break;
+        }
+        if ((*steps & 63) == 0 && qol_timer_elapsed(&t) > budget) break;
+    }
+    if (*steps > (long)s.max + 1) finished = true;
+    *elapsed = qol_timer_elapsed(&t);
+    *cost = found ? search_path_cost(&s) : -1;
+    search_free(&s);
+    return finished;
+}
+
+
+// Greedy best-first as it was before the bucket queue: a scan of every slot
+// per step for the open cell with the smallest h, ties to the lowest slot.
+// Kept as the baseline for bench_greedy().
+static bool bench_greedy_scan_step(SearchState *s) {
+    if (s->unreachable) return false;
+    int bestIdx = -1;
+    int bestScore = INF;
+    for (int i = 0; i < s->max; i++) {
+        if (s->visited[i] && !s->processed[i]) {
+            int h = abs(search_x(s, i) - s->goalX) + abs(search_y(s, i) - s->goalY);
+            if (h < bestScore) {
+                bestScore = h;
+                bestIdx = i;
+            }
+        }
+    }
+    if (bestIdx == -1) return false;
+
+    int x = search_x(s, bestIdx);
+    int y = search_y(s, bestIdx);
+    s->processed[bestIdx] = 1;
+
+    if (x == s->goalX && y == s->goalY) {
+        build_path(s);
+        return true;
+    }
+
+    for (unsigned m = search_neighbors(s, bestIdx); m; m &= m - 1) {
+        int idx = search_move(s, bestIdx, __builtin_ctz(m));
+        if (!s->visited[idx]) {
+            s->visited[idx] = 1;
+            s->parent[idx] = bestIdx;
+        }
+    }
+    return false;
+}
+
+// The selected stepper, which must be algo, against its full-scan baseline
+// on braided mazes: steps, time per step and path cost. Optimal searches
+// are also run on terrain costs and must match the scan's cost.
+static void bench_queue_vs_scan(const char *algo, const char *queue, bool (*scan)(SearchState *), bool optimal) {
+    const int sizes[] = { 255, 1023, 4095, 8191 };
+    const double budget = 30.0;
+
+    if (strcmp(ALGO_NAME, algo) != 0) {
+        qol_info("%s %s vs scan: select it in maze.h to run this section (built with %s)\n", algo, queue, ALGO_NAME);
+        return;
+    }
+    qol_info("%s %s vs full scan (braided mazes, corner to corner, scan gives up after %.0fs)\n", algo, queue, budget);
+    for (int i = 0; i < (int)QOL_ARRAY_LEN(sizes); i++) {
+        int N = sizes[i];
+        Grid maze;
+        grid_init(&maze, N);
+        grid_clear(&maze);
+        Rng rng;
+        rng_seed(&rng, BENCH_SEED);
+        GenerateMazeWith(&maze, GEN_BRAIDED, &rng);
+        NeighborMasks masks;
+        neighbor_masks_init(&masks, N);
+        neighbor_masks_build(&masks, &maze);
+        CostGrid costs;
+        cost_grid_init(&costs, N);
+        GenerateTerrainCosts(&costs, &rng, TERRAIN_MAX_COST);
+
+        for (int weighted = 0; weighted < (optimal ? 2 : 1); weighted++) {
+            const CostGrid *c = weighted ? &costs : NULL;
+            double queueTime, scanTime;
+            long queueSteps, scanSteps, queueCost, scanCost;
+            bench_search_with(&maze, &masks, c, bench_selected_step, budget, &queueTime, &queueSteps, &queueCost);
+            bool scanDone = N <= 1023 && bench_search_with(&maze, &masks, c, scan, budget, &scanTime, &scanSteps, &scanCost);
+            char scanText[96] = "skipped";
+            if (scanDone) {
+                snprintf(scanText, sizeof(scanText), "scan %8ld steps %9.3fs  %7.1fx  %s", scanSteps, scanTime,
+                         scanTime / queueTime, !optimal ? "" : scanCost == queueCost ? "same cost" : "COST MISMATCH");
+            } else if (N <= 1023) {
+                snprintf(scanText, sizeof(scanText), "scan gave up after %ld steps", scanSteps);
+            }
+            qol_info("  N=%-5d %-7s %8ld steps %9.3fs %6.1f ns/step  cost %8ld   %s\n", N, weighted ? "terrain" : "unit",
+                     queueSteps, queueTime, queueTime * 1e9 / queueSteps, queueCost, scanText);
+        }
+        cost_grid_free(&costs);
+        neighbor_masks_free(&masks);
+        grid_free(&maze);
+    }
+}
+
+static void bench_astar(void) {
+    bench_queue_vs_scan("A*", "indexed heap", bench_astar_scan_step, true);
+}
+
+static void bench_greedy(void) {
+    bench_queue_vs_scan("Greedy", "bucket queue", bench_greedy_scan_step, false);
+}
+
+// The selected stepper (Dijkstra or A*) run to the goal with every queue of
+// pqueue.h on braided mazes, with unit and terrain costs: total time, queue
+// operations per second and the path cost, which must match the binary heap.
+// Radix pops include the stale copies it skips.
+static void bench_queues(void) {
+    const int sizes[] = { 1023, 4095, 8191 };
+
+    if (strcmp(ALGO_NAME, "Dijkstra") != 0 && strcmp(ALGO_NAME, "A*") != 0) {
+        qol_info("Queues: select Dijkstra or A* in maze.h to run this section (built with %s)\n", ALGO_NAME);
+        return;
+    }
+    qol_info("%s priority queues (braided mazes, corner to corner)\n", ALGO_NAME);
+    for (int i = 0; i < (int)QOL_ARRAY_LEN(sizes); i++) {
+        int N = sizes[i];
+        Grid maze;
+        grid_init(&maze, N);
+        grid_clear(&maze);
+        Rng rng;
+        rng_seed(&rng, BENCH_SEED);
+        GenerateMazeWith(&maze, GEN_BRAIDED, &rng);
+        NeighborMasks masks;
+        neighbor_masks_init(&masks, N);
+        neighbor_masks_build(&masks, &maze);
+        CostGrid costs;
+        cost_grid_init(&costs, N);
+        GenerateTerrainCosts(&costs, &rng, TERRAIN_MAX_COST);
+
+        for (int weighted = 0; weighted < 2; weighted++) {
+            long binaryCost = -1;
+            double binaryTime = 0.0;
+            for (int q = 0; q < QUEUE_COUNT; q++) {
+                rng_seed(&rng, BENCH_SEED);
+                SearchState s = {0};
+                search_init(&s, N, &maze, 1, 1, N - 2, N - 2, &rng);
+                search_set_costs(&s, weighted ? &costs : NULL);
+                search_set_masks(&s, &masks);
+                search_set_queue(&s, (SearchQueue)q);
+                long steps = 0;
+                QOL_Timer t;
+                qol_timer_start(&t);
+                bool found = RunSearch(&s, &steps);
+                double dt = qol_timer_elapsed(&t);
+                long cost = found ? search_path_cost(&s) : -1;
+                if (q == QUEUE_BINARY) {
+                    binaryCost = cost;
+                    binaryTime = dt;
+                }
+                qol_info("  N=%-5d %-7s %-6s %9ld steps %8.3fs %5.2fx  %6.1f M push/s %6.1f M pop/s  cost %8ld%s\n",
+                         N, weighted ? "terrain" : "unit", QUEUE_NAMES[q], steps, dt, binaryTime / dt,
+                         (double)s.pushes / dt * 1e-6, (double)s.pops / dt * 1e-6, cost,
+                         cost == binaryCost ? "" : "  COST MISMATCH");
+                search_free(&s);
+            }
+        }
+        cost_grid_free(&costs);
+        neighbor_masks_free(&masks);
+        grid_free(&maze);
+    }
+}
+
+// Replay a recorded queue trace through queue q on a fresh search state of
+// maze, timing the queue operations alone. A queue may pop a different slot
+// than the recorded one when their keys tie, so trace slots are mapped to
+// queue slots and the two are swapped on such a pop; every popped key must
+// still match the trace. Returns whether it did.
+static bool bench_replay_trace(const Grid *maze, const CostGrid *costs, const QueueTrace *trace, SearchQueue q, double *elapsed) {
+    int N = maze->N;
+    Rng rng;
+    rng_seed(&rng, BENCH_SEED);
+    SearchState s = {0};
+    search_init(&s, N, maze, 1, 1, N - 2, N - 2, &rng);
+    search_set_costs(&s, costs);
+    search_set_queue(&s, q);
+    int *map = malloc((size_t)s.max * sizeof(int));
+    int *inv = malloc((size_t)s.max * sizeof(int));
+    for (int i = 0; i < s.max; i++) map[i] = inv[i] = i;
+
+    bool ok = true;
+    QOL_Timer t;
+    qol_timer_start(&t);
+    for (size_t i = 0; i < trace->len && ok; i++) {
+        const QueueOp *op = &trace->data[i];
+        if (op->op == QUEUE_OP_PUSH) {
+            int b = map[op->slot];
+            s.fscore[b] = op->key;
+            s.dist[b] = op->g;
+            search_queue_push(&s, b);
+            continue;
+        }
+        int b = search_queue_pop(&s);
+        if (b < 0 || s.fscore[b] != op->key) {
+            ok = false;
+            break;
+        }
+        s.processed[b] = 1;
+        int want = map[op->slot];
+        if (b != want) {
+            int other = inv[b];
+            map[op->slot] = b;
+            inv[b] = op->slot;
+            map[other] = want;
+            inv[want] = other;
+        }
+    }
+    *elapsed = qol_timer_elapsed(&t);
+    free(map);
+    free(inv);
+    search_free(&s);
+    return ok;
+}
+
+// Queue traces of the selected stepper (Dijkstra or A*) recorded from real
+// corner-to-corner searches and replayed through every queue, so the queues
+// are compared on the same operation sequence without the search around
+// them: braided mazes with unit and terrain costs, and open terrain fields.
+static void bench_queue_traces(void) {
+    const int sizes[] = { 1023, 4095 };
+    const char *workloads[] = { "braided unit", "braided terrain", "open terrain" };
+
+    if (strcmp(ALGO_NAME, "Dijkstra") != 0 && strcmp(ALGO_NAME, "A*") != 0) {
+        qol_info("Queue traces: select Dijkstra or A* in maze.h to run this section (built with %s)\n", ALGO_NAME);
+        return;
+    }
+    qol_info("%s queue traces replayed per queue (corner to corner)\n", ALGO_NAME);
+    for (int i = 0; i < (int)QOL_ARRAY_LEN(sizes); i++) {
+        int N = sizes[i];
+        for (int w = 0; w < (int)QOL_ARRAY_LEN(workloads); w++) {
+            Rng rng;
+            rng_seed(&rng, BENCH_SEED);
+            Grid maze;
+            grid_init(&maze, N);
+            grid_clear(&maze);
+            if (w < 2) {
+                GenerateMazeWith(&maze, GEN_BRAIDED, &rng);
+            } else {
+                for (int y = 0; y < N; y++) {
+                    for (int x = 0; x < N; x++) grid_set(&maze, x, y, PATH);
+                }
+            }
+            NeighborMasks masks;
+            neighbor_masks_init(&masks, N);
+            neighbor_masks_build(&masks, &maze);
+            CostGrid costs;
+            cost_grid_init(&costs, N);
+            GenerateTerrainCosts(&costs, &rng, TERRAIN_MAX_COST);
+            const CostGrid *c = w > 0 ? &costs : NULL;
+
+            QueueTrace trace = {0};
+            SearchState s = {0};
+            rng_seed(&rng, BENCH_SEED);
+            search_init(&s, N, &maze, 1, 1, N - 2, N - 2, &rng);
+            search_set_costs(&s, c);
+            search_set_masks(&s, &masks);
+            search_set_trace(&s, &trace);
+            long steps = 0;
+            RunSearch(&s, &steps);
+            search_free(&s);
+
+            long pushes = 0, decreases = 0, pops = 0;
+            bool *queued = calloc((size_t)layout_cells(SEARCH_LAYOUT, N), sizeof(bool));
+            for (size_t k = 0; k < trace.len; k++) {
+                const QueueOp *op = &trace.data[k];
+                if (op->op == QUEUE_OP_POP) {
+                    pops++;
+                    queued[op->slot] = false;
+                } else if (queued[op->slot]) {
+                    decreases++;
+                } else {
+                    pushes++;
+                    queued[op->slot] = true;
+                }
+            }
+            free(queued);
+            qol_info("  N=%-5d %-15s %9ld pushes %9ld decrease-keys %9ld pops\n", N, workloads[w], pushes, decreases, pops);
+
+            double binaryTime = 0.0, bestTime = 0.0;
+            int best = -1;
+            for (int q = 0; q < QUEUE_COUNT; q++) {
+                double dt;
+                bool ok = bench_replay_trace(&maze, c, &trace, (SearchQueue)q, &dt);
+                if (q == QUEUE_BINARY) binaryTime = dt;
+                if (ok && (best < 0 || dt < bestTime)) {
+                    best = q;
+                    bestTime = dt;
+                }
+                qol_info("    %-7s %8.3fs %5.2fx %7.1f M ops/s%s\n", QUEUE_NAMES[q], dt, binaryTime / dt,
+                         (double)trace.len / dt * 1e-6, ok ? "" : "  KEY MISMATCH");
+            }
+            if (best >= 0) qol_info("    fastest: %s\n", QUEUE_NAMES[best]);
+
+            qol_release(&trace);
+            cost_grid_free(&costs);
+            neighbor_masks_free(&masks);
+            grid_free(&maze);
+        }
+    }
+}
+
+typedef struct {
+    const char *name;
+    void (*fn)(void);
+} BenchSection;
+
+static BenchSection bench_sections[] = {
+    { "backtracker", bench_backtracker },
+    { "tiled",       bench_tiled },
+    { "gen",         bench_generator_matrix },
+    { "bulk",        bench_bulk },
+    { "junction",    bench_junction },
+    { "csr",         bench_csr },
+    { "components",  bench_components },
+    { "lca",         bench_tree_index },
+    { "braid",       bench_braid },
+    { "masks",       bench_neighbor_masks },
+    { "layout",      bench_layout },
+    { "dynamic",     bench_dynamic },
+    { "astar",       bench_astar },
+    { "greedy",      bench_greedy },
+    { "queues",      bench_queues },
+    { "pqtrace",     bench_queue_traces },
+};
+
+// bench [section...]: run the named sections, or all of them
+void bench(int argc, char **argv) {
+    for (int i = 0; i < (int)QOL_ARRAY_LEN(bench_sections); i++) {
+        bool selected = argc == 0;
+        for (int a = 0; a < argc; a++) {
+            if (strcmp(argv[a], bench_sections[i].name) == 0) selected = true;
+        }
+        if (selected) bench_sections[i].fn();
+    }
+    for (int a = 0; a < argc; a++) {
+        bool known = false;
+        for (int i = 0; i < (int)QOL_ARRAY_LEN(bench_sections); i++) {
+            if (strcmp(argv[a], bench_sections[i].name) == 0) known = true;
+        }
+        if (!known) qol_warn("Unknown bench section: %s\n", argv[a]);
+    }
+}
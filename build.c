@@ -18,6 +18,7 @@ int main() {
     push(&cmd_plasma, "-Wl,-rpath,@executable_path/libs/raylib-5.5_macos/lib");
     push(&cmd_plasma, "-lraylib");
     push(&cmd_plasma, "-lm");
+    push(&cmd_plasma, "-pthread");
     push(&cmd_plasma, "-o", "main", "main.c");
 
     if (!run_always(&cmd_plasma)) return 1;
@@ -3,24 +3,44 @@
 
 #include "maze.h"
 #include "sort.h"
+#include "bench.h"
+#include "tools.h"
 
-typedef void (*cmd_fn)(void);
+typedef void (*cmd_fn)(int argc, char **argv);
 typedef struct {
     const char *name;
     cmd_fn fn;
 } Command;
 
-void usage() {
-    qol_warn("Usage: <program> <param>\n");
+void usage(int argc, char **argv) {
+    QOL_UNUSED(argc);
+    QOL_UNUSED(argv);
+    qol_warn("Usage: <program> <param> [args...]\n");
     qol_warn("param:\n");
     qol_warn("  maze   - Path finding Algorithms like Dijkstra.\n");
-    qol_warn("  sort   - Sorting Algorithms like Merge Sort.\n");
+    qol_warn("  sort [seed] - Sorting Algorithms like Merge Sort.\n");
+    qol_warn("  bench  - Headless benchmarks (maze generation, ...).\n");
+    qol_warn("  maze-stream <w> <h> <out> [seed] - Stream a maze of any height to disk (Eller).\n");
+    qol_warn("  maze-save <out> [N] [seed] [gen] - Generate a maze and save it to a maze file.\n");
+    qol_warn("  maze-load <file> [queue] - Map a maze file and solve it headless.\n");
+    qol_warn("  maze-world <x0> <y0> <x1> <y1> [seed] [cache] - Solve in the unbounded chunked maze.\n");
+    qol_warn("  maze-scen <file.scen> [map dir] - Run a Moving AI benchmark scenario set.\n");
+    qol_warn("  maze-terrain [N] [seed] [max cost] [queue] - Solve a weighted noise-terrain field.\n");
+    qol_warn("  maze-stats [N] [seed] [gen] [threads] | <file> [threads] - Maze statistics as JSON.\n");
     qol_warn("  usage  - Show this usage information\n");
 }
 
 static Command commands[] = {
     { "maze",  maze },
     { "sort",  sort },
+    { "bench", bench },
+    { "maze-stream", maze_stream },
+    { "maze-save", maze_save },
+    { "maze-load", maze_load },
+    { "maze-world", maze_world },
+    { "maze-scen", maze_scen },
+    { "maze-terrain", maze_terrain },
+    { "maze-stats", maze_stats },
     { "usage", usage },
 };
 
@@ -35,8 +55,10 @@ cmd_fn lookup_command(const char *name) {
 }
 
 int main(int argc, char** argv) {
-    if (argc < 2) usage();
-    
+    if (argc < 2) {
+        usage(argc, argv);
+        return EXIT_FAILURE;
+    }
 
     qol_shift(argc, argv); 
     const char* val = qol_shift(argc, argv);
@@ -44,11 +66,11 @@ int main(int argc, char** argv) {
 
     if (!fn) {
         qol_error("Unknown type: %s\n", val);
-        usage();
+        usage(argc, argv);
         return EXIT_FAILURE;
     }
 
-    fn();
+    fn(argc, argv);
 
     return EXIT_SUCCESS;
 }
@@ -8,11 +8,15 @@
 #define WALL 1
 #define PATH 0
 
-#define INF 1000000
+#define INF 0x3fffffff
 #define TICK 0.025f // seconds per step
-#define SEED -1 // -1 for random seed
+#define SEED -1 // -1 for random seed, otherwise every run is reproducible
 
-static int dirs[4][2] = {{0,-1},{1,0},{0,1},{-1,0}};
+static const int dirs[4][2] = {{0,-1},{1,0},{0,1},{-1,0}};
+
+// Default cell numbering of the search arrays and neighbour masks, see
+// algorithms/maze/layout.h: LAYOUT_ROW or LAYOUT_MORTON (Z-order)
+#define SEARCH_LAYOUT LAYOUT_ROW
 
 #include "algorithms/maze/common.h"
 
@@ -22,43 +26,101 @@ static int dirs[4][2] = {{0,-1},{1,0},{0,1},{-1,0}};
 // #include "algorithms/maze/greedy.h"
 // #include "algorithms/maze/astar.h"
 #include "algorithms/maze/dijkstra.h"
+#include "algorithms/maze/dynamic.h"
+
+#include "algorithms/generate/backtracker.h"
+#include "algorithms/generate/tiled.h"
+#include "algorithms/generate/eller.h"
+#include "algorithms/generate/kruskal.h"
+#include "algorithms/generate/wilson.h"
+#include "algorithms/generate/terrain.h"
+#include "algorithms/generate/braid.h"
+#include "algorithms/generate/binarytree.h"
+
+typedef enum {
+    GEN_BACKTRACKER,
+    GEN_TILED,
+    GEN_ELLER,
+    GEN_KRUSKAL,
+    GEN_WILSON,
+    GEN_BRAIDED,
+    GEN_BINARY_TREE,
+    GEN_SIDEWINDER,
+    GEN_COUNT,
+} MazeGen;
+
+static const char *GEN_NAMES[GEN_COUNT] = {
+    [GEN_BACKTRACKER] = "Backtracker",
+    [GEN_TILED]       = "Tiled (parallel)",
+    [GEN_ELLER]       = "Eller",
+    [GEN_KRUSKAL]     = "Kruskal",
+    [GEN_WILSON]      = "Wilson",
+    [GEN_BRAIDED]     = "Braided",
+    [GEN_BINARY_TREE] = "Binary tree",
+    [GEN_SIDEWINDER]  = "Sidewinder",
+};
+
+// Perfect mazes have exactly one path between any two rooms
+static inline bool GenIsPerfect(MazeGen gen) {
+    return gen != GEN_BRAIDED;
+}
 
-void ShuffleDirs() {
-    for (int i = 0; i < 4; i++) {
-        int r = rand() % 4;
-        int tmp0 = dirs[i][0];
-        int tmp1 = dirs[i][1];
-        dirs[i][0] = dirs[r][0];
-        dirs[i][1] = dirs[r][1];
-        dirs[r][0] = tmp0;
-        dirs[r][1] = tmp1;
+// Generator used on startup, press g to cycle
+#define GENERATOR GEN_BACKTRACKER
+
+// Highest cell cost of generated terrain (press t to toggle weighted costs)
+#define TERRAIN_MAX_COST 9
+
+// Braided generator: backtracker, then this share of dead ends opened and
+// this chance of knocking out each interior wall
+#define BRAID_DEAD_ENDS 0.5
+#define BRAID_LOOPS 0.02
+
+static void GenerateMazeWith(Grid *maze, MazeGen gen, Rng *rng) {
+    switch (gen) {
+        case GEN_TILED: GenerateMazeTiled(maze, rng, 0); break;
+        case GEN_ELLER: GenerateMazeEller(maze, rng); break;
+        case GEN_KRUSKAL: GenerateMazeKruskal(maze, rng); break;
+        case GEN_WILSON: GenerateMazeWilson(maze, rng); break;
+        case GEN_BINARY_TREE: GenerateMazeBinaryTree(maze, rng); break;
+        case GEN_SIDEWINDER: GenerateMazeSidewinder(maze, rng); break;
+        case GEN_BRAIDED:
+            GenerateMaze(maze, 1, 1, rng);
+            BraidMaze(maze, rng, BRAID_DEAD_ENDS, BRAID_LOOPS);
+            break;
+        case GEN_BACKTRACKER:
+        default: GenerateMaze(maze, 1, 1, rng); break;
     }
 }
 
-void GenerateMaze(int **maze, int x, int y, int n) {
-    maze[y][x] = PATH;
-    ShuffleDirs();
-
-    for (int i = 0; i < 4; i++) {
-        int nx = x + dirs[i][0] * 2;
-        int ny = y + dirs[i][1] * 2;
-
-        if (nx > 0 && nx < n-1 && ny > 0 && ny < n-1) {
-            if (maze[ny][nx] == WALL) {
-                maze[y + dirs[i][1]][x + dirs[i][0]] = PATH;
-                GenerateMaze(maze, nx, ny, n);
-            }
-        }
+// Step the selected algorithm to completion without drawing. Every step
+// settles at most one cell, so search_cell_bound() + 1 steps without
+// reaching the goal means it is unreachable. Returns whether the goal was
+// found.
+static bool RunSearch(SearchState *state, long *steps) {
+    if (state->unreachable) {
+        *steps = 0;
+        return false;
+    }
+    long limit = search_cell_bound(state) + 1;
+    for (*steps = 1; *steps <= limit; (*steps)++) {
+        if (step(state)) return true;
     }
+    return false;
 }
 
-static void ResetRun(
-    int **maze,
+// Start a fresh search between the given cells of the current maze
+static void RestartSearch(
+    const Grid *maze,
+    Rng *rng,
+    CostGrid *costs,
+    NeighborMasks *masks,
+    ComponentIndex *comps,
     int N,
-    int *startX,
-    int *startY,
-    int *goalX,
-    int *goalY,
+    int startX,
+    int startY,
+    int goalX,
+    int goalY,
     SearchState *state,
     bool *found,
     int *pathLen,
@@ -67,31 +129,15 @@ static void ResetRun(
     int *stepCount,
     QOL_Timer *searchTimer
 ) {
-    // clear and regenerate maze
-    for (int y = 0; y < N; y++) {
-        for (int x = 0; x < N; x++) {
-            maze[y][x] = WALL;
-        }
-    }
-    GenerateMaze(maze, 1, 1, N);
-
-    // pick new start/goal on PATH cells
-    do {
-        *startX = rand() % N;
-        *startY = rand() % N;
-    } while (maze[*startY][*startX] == WALL);
-
-    do {
-        *goalX = rand() % N;
-        *goalY = rand() % N;
-    } while ((*goalX == *startX && *goalY == *startY) || maze[*goalY][*goalX] == WALL);
-
     // free previous search buffers if any, then reinit
     if (state->visited) {
         search_free(state);
     }
     *state = (SearchState){0};
-    search_init(state, N, maze, *startX, *startY, *goalX, *goalY);
+    search_init(state, N, maze, startX, startY, goalX, goalY, rng);
+    search_set_costs(state, costs);
+    search_set_masks(state, masks);
+    if (comps) search_check_components(state, comps);
 
     // reset runtime stats/timers
     *found = false;
@@ -102,22 +148,77 @@ static void ResetRun(
     qol_timer_start(searchTimer);
 }
 
-void maze(void) {
+// Pick distinct random start and goal cells on PATH
+static void PickEndpoints(const Grid *maze, Rng *rng, int N, int *startX, int *startY, int *goalX, int *goalY) {
+    do {
+        *startX = (int)rng_below(rng, N);
+        *startY = (int)rng_below(rng, N);
+    } while (grid_get(maze, *startX, *startY) == WALL);
+
+    do {
+        *goalX = (int)rng_below(rng, N);
+        *goalY = (int)rng_below(rng, N);
+    } while ((*goalX == *startX && *goalY == *startY) || grid_get(maze, *goalX, *goalY) == WALL);
+}
+
+static void ResetRun(
+    Grid *maze,
+    MazeGen gen,
+    Rng *rng,
+    CostGrid *costs,
+    NeighborMasks *masks,
+    ComponentIndex *comps,
+    int N,
+    int *startX,
+    int *startY,
+    int *goalX,
+    int *goalY,
+    SearchState *state,
+    bool *found,
+    int *pathLen,
+    float *tickTime,
+    double *timeFound,
+    int *stepCount,
+    QOL_Timer *searchTimer
+) {
+    // clear and regenerate maze
+    grid_clear(maze);
+    GenerateMazeWith(maze, gen, rng);
+    if (costs) GenerateTerrainCosts(costs, rng, TERRAIN_MAX_COST);
+    if (masks) neighbor_masks_build(masks, maze);
+    if (comps) {
+        if (comps->label) components_free(comps);
+        components_build(comps, maze, 1);
+    }
+
+    PickEndpoints(maze, rng, N, startX, startY, goalX, goalY);
+    RestartSearch(maze, rng, costs, masks, comps, N, *startX, *startY, *goalX, *goalY, state, found, pathLen, tickTime, timeFound, stepCount, searchTimer);
+}
+
+void maze(int argc, char **argv) {
+    QOL_UNUSED(argc);
+    QOL_UNUSED(argv);
     const int N = 31;           // must be odd
     const int CELL = 20;        // cell size in pixels
     const int SCREEN = N * CELL;
 
-    unsigned int seed_value = (SEED == -1) ? (unsigned int)time(NULL) : (unsigned int)SEED;
-    srand(seed_value);
+    uint64_t seed_value = (SEED == -1) ? (uint64_t)time(NULL) : (uint64_t)SEED;
+    Rng rng;
+    rng_seed(&rng, seed_value);
 
     // Allocate maze
-    int **maze = malloc(N * sizeof(int*));
-    for (int i = 0; i < N; i++) {
-        maze[i] = malloc(N * sizeof(int));
-        for (int j = 0; j < N; j++) maze[i][j] = WALL;
-    }
+    Grid maze;
+    grid_init(&maze, N);
+    grid_clear(&maze);
 
     // Generate maze
+    MazeGen gen = GENERATOR;
+    CostGrid costs;
+    cost_grid_init(&costs, N);
+    bool weighted = false;
+    NeighborMasks masks;
+    neighbor_masks_init(&masks, N);
+    ComponentIndex comps = {0};
     int startX, startY, goalX, goalY;
     SearchState state = {0};
     bool found = false;
@@ -126,7 +227,7 @@ void maze(void) {
     double timeFound = 0.0;
     int stepCount = 0;   // number of search steps performed
     QOL_Timer searchTimer;
-    ResetRun(maze, N, &startX, &startY, &goalX, &goalY, &state, &found, &pathLen, &tickTime, &timeFound, &stepCount, &searchTimer);
+    ResetRun(&maze, gen, &rng, weighted ? &costs : NULL, &masks, &comps, N, &startX, &startY, &goalX, &goalY, &state, &found, &pathLen, &tickTime, &timeFound, &stepCount, &searchTimer);
 
     // Persistent colors
     const Color startColor = YELLOW;
@@ -138,24 +239,48 @@ void maze(void) {
 
     while (!WindowShouldClose()) {
         BeginDrawing();
+            if (IsKeyPressed(KEY_G)) {
+                gen = (gen + 1) % GEN_COUNT;
+                ResetRun(&maze, gen, &rng, weighted ? &costs : NULL, &masks, &comps, N, &startX, &startY, &goalX, &goalY, &state, &found, &pathLen, &tickTime, &timeFound, &stepCount, &searchTimer);
+            }
+            if (IsKeyPressed(KEY_T)) {
+                weighted = !weighted;
+                ResetRun(&maze, gen, &rng, weighted ? &costs : NULL, &masks, &comps, N, &startX, &startY, &goalX, &goalY, &state, &found, &pathLen, &tickTime, &timeFound, &stepCount, &searchTimer);
+            }
             if (IsKeyPressed(KEY_R)) {
-                ResetRun(maze, N, &startX, &startY, &goalX, &goalY, &state, &found, &pathLen, &tickTime, &timeFound, &stepCount, &searchTimer);
+                ResetRun(&maze, gen, &rng, weighted ? &costs : NULL, &masks, &comps, N, &startX, &startY, &goalX, &goalY, &state, &found, &pathLen, &tickTime, &timeFound, &stepCount, &searchTimer);
+            }
+            if (IsKeyPressed(KEY_E)) {
+                // Toggle the wall under the mouse; the search only starts
+                // over if the edit reaches cells it has already seen
+                int ex = GetMouseX() / CELL, ey = GetMouseY() / CELL;
+                bool endpoint = (ex == startX && ey == startY) || (ex == goalX && ey == goalY);
+                if (ex >= 0 && ex < N && ey >= 0 && ey < N && !endpoint) {
+                    int v = grid_get(&maze, ex, ey) == WALL ? PATH : WALL;
+                    if (dynamic_set(&maze, &masks, &comps, &state, ex, ey, v)) {
+                        RestartSearch(&maze, &rng, weighted ? &costs : NULL, &masks, &comps, N, startX, startY, goalX, goalY, &state, &found, &pathLen, &tickTime, &timeFound, &stepCount, &searchTimer);
+                    }
+                }
             }
             ClearBackground(BLACK);
 
             // Draw maze
             for (int y = 0; y < N; y++) {
                 for (int x = 0; x < N; x++) {
-                    Color c = (maze[y][x] == WALL) ? BLACK : RAYWHITE;
+                    Color c = (grid_get(&maze, x, y) == WALL) ? BLACK : RAYWHITE;
+                    if (weighted && grid_get(&maze, x, y) == PATH) {
+                        // darker = more expensive
+                        unsigned char v = (unsigned char)(245 - 150 * (cost_get(&costs, x, y) - 1) / (TERRAIN_MAX_COST > 1 ? TERRAIN_MAX_COST - 1 : 1));
+                        c = (Color){ v, (unsigned char)(v - v / 8), (unsigned char)(v - v / 4), 255 };
+                    }
                     DrawRectangle(x * CELL, y * CELL, CELL, CELL, c);
                 }
             }
 
             // Visualize visited/search frontier
-            for (int i = 0; i < N * N; i++) {
-                if (state.visited[i]) {
-                    int x = i % N;
-                    int y = i / N;
+            for (int y = 0; y < N; y++) {
+                for (int x = 0; x < N; x++) {
+                    if (!state.visited[search_index(&state, x, y)]) continue;
                     if (!((x == startX && y == startY) || (x == goalX && y == goalY))) {
                         DrawRectangle(x * CELL, y * CELL, CELL, CELL, Fade(pathColor, 0.2f));
                     }
@@ -193,16 +318,19 @@ void maze(void) {
             DrawRectangle(goalX * CELL, goalY * CELL, CELL, CELL, goalColor);
             DrawCircle(startX * CELL + CELL/2, startY * CELL + CELL/2, CELL/3, startColor);
             DrawCircle(goalX * CELL + CELL/2, goalY * CELL + CELL/2, CELL/3, goalColor);
+            if (state.unreachable) {
+                DrawText("goal unreachable", 10, 10, 20, goalColor);
+            }
 
             // Info popup when goal is reached
             if (found) {
                 int visitedCount = 0;
-                for (int i = 0; i < N * N; i++) {
+                for (int i = 0; i < state.max; i++) {
                     if (state.visited[i]) visitedCount++;
                 }
 
                 const int panelW = 340;
-                const int panelH = 170;
+                const int panelH = weighted ? 210 : 190;
                 const int panelX = (SCREEN - panelW) / 2;
                 const int panelY = 20;
                 DrawRectangle(panelX, panelY, panelW, panelH, Fade(BLACK, 0.8f));
@@ -215,6 +343,9 @@ void maze(void) {
                 snprintf(buf, sizeof(buf), "algo: %s", ALGO_NAME);
                 DrawText(buf, panelX + 10, lineY, 18, YELLOW); lineY += 20;
 
+                snprintf(buf, sizeof(buf), "maze: %s", GEN_NAMES[gen]);
+                DrawText(buf, panelX + 10, lineY, 18, YELLOW); lineY += 20;
+
                 snprintf(buf, sizeof(buf), "time: %.3fs", timeFound);
                 DrawText(buf, panelX + 10, lineY, 18, YELLOW); lineY += 20;
 
@@ -229,6 +360,11 @@ void maze(void) {
                 snprintf(buf, sizeof(buf), "path len: %d", pathLen);
                 DrawText(buf, panelX + 10, lineY, 18, YELLOW); lineY += 20;
 
+                if (weighted) {
+                    snprintf(buf, sizeof(buf), "path cost: %ld", search_path_cost(&state));
+                    DrawText(buf, panelX + 10, lineY, 18, YELLOW); lineY += 20;
+                }
+
                 snprintf(buf, sizeof(buf), "visited: %d", visitedCount);
                 DrawText(buf, panelX + 10, lineY, 18, YELLOW);
             }
@@ -238,7 +374,9 @@ void maze(void) {
 
     CloseWindow();
 
-    for (int i = 0; i < N; i++) free(maze[i]);
-    free(maze);
+    grid_free(&maze);
+    cost_grid_free(&costs);
+    neighbor_masks_free(&masks);
+    components_free(&comps);
     if (state.visited) search_free(&state);
 }
@@ -0,0 +1,91 @@
+#pragma once
+#include <stdint.h>
+
+// xoshiro256** (Blackman & Vigna). Small, fast, and its jump() advances a
+// state by 2^128 draws, which gives non-overlapping streams for threads or
+// tiles that can be derived from one seed in a fixed order. The state is
+// plain data: copy it to fork, never share one Rng between threads.
+typedef struct {
+    uint64_t s[4];
+} Rng;
+
+static inline uint64_t rng_rotl(uint64_t x, int k) {
+    return (x << k) | (x >> (64 - k));
+}
+
+// Seed all four words through splitmix64, so any seed (including 0) is fine
+static inline void rng_seed(Rng *r, uint64_t seed) {
+    for (int i = 0; i < 4; i++) {
+        uint64_t z = (seed += 0x9e3779b97f4a7c15ULL);
+        z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+        z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+        r->s[i] = z ^ (z >> 31);
+    }
+}
+
+static inline uint64_t rng_next(Rng *r) {
+    uint64_t *s = r->s;
+    uint64_t result = rng_rotl(s[1] * 5, 7) * 9;
+    uint64_t t = s[1] << 17;
+    s[2] ^= s[0];
+    s[3] ^= s[1];
+    s[1] ^= s[2];
+    s[0] ^= s[3];
+    s[2] ^= t;
+    s[3] = rng_rotl(s[3], 45);
+    return result;
+}
+
+// Uniform integer in [0, n), n > 0 (Lemire's multiply-shift with rejection)
+static inline uint32_t rng_below(Rng *r, uint32_t n) {
+    uint64_t m = (uint64_t)(uint32_t)(rng_next(r) >> 32) * n;
+    if ((uint32_t)m < n) {
+        uint32_t threshold = (uint32_t)-n % n;
+        while ((uint32_t)m < threshold) m = (uint64_t)(uint32_t)(rng_next(r) >> 32) * n;
+    }
+    return (uint32_t)(m >> 32);
+}
+
+// Uniform integer in [0, n), n > 0, for bounds past 32 bits
+static inline uint64_t rng_below64(Rng *r, uint64_t n) {
+    if (n <= UINT32_MAX) return rng_below(r, (uint32_t)n);
+    uint64_t threshold = -n % n;
+    uint64_t x;
+    do x = rng_next(r);
+    while (x < threshold);
+    return x % n;
+}
+
+// Advance by 2^128 draws
+static inline void rng_jump(Rng *r) {
+    static const uint64_t JUMP[] = {
+        0x180ec6d33cfd0abaULL, 0xd5a61266f0c9392cULL,
+        0xa9582618e03fc9aaULL, 0x39abdc4529b1661cULL,
+    };
+    uint64_t s0 = 0, s1 = 0, s2 = 0, s3 = 0;
+    for (int i = 0; i < 4; i++) {
+        for (int b = 0; b < 64; b++) {
+            if (JUMP[i] & ((uint64_t)1 << b)) {
+                s0 ^= r->s[0];
+                s1 ^= r->s[1];
+                s2 ^= r->s[2];
+                s3 ^= r->s[3];
+            }
+            rng_next(r);
+        }
+    }
+    r->s[0] = s0;
+    r->s[1] = s1;
+    r->s[2] = s2;
+    r->s[3] = s3;
+}
+
+// Fill out[0..count) with consecutive jumped streams of base; base itself is
+// left untouched and never overlaps them.
+static inline void rng_streams(const Rng *base, Rng *out, int count) {
+    Rng cur = *base;
+    for (int i = 0; i < count; i++) {
+        rng_jump(&cur);
+        out[i] = cur;
+    }
+}
@@ -5,9 +5,11 @@
 
 #define QOL_IMPLEMENTATION
 #include "libs/build.h"
+#include "rng.h"
 
 #define SORT_TICK 0.0f
 #define SORT_MAX_VALUE 420
+#define SORT_SEED -1 // -1 for random seed, otherwise every run is reproducible
 
 #include "algorithms/sort/common.h"
 
@@ -18,7 +20,7 @@
 // #include "algorithms/sort/quick.h"
 // #include "algorithms/sort/heap.h"
 
-static void sort_state_reset_common(SortState *s, int n) {
+static void sort_state_reset_common(SortState *s, int n, Rng *rng) {
     s->n = n;
     s->i = s->j = s->k = 0;
     s->minIdx = 0;
@@ -39,7 +41,7 @@ static void sort_state_reset_common(SortState *s, int n) {
     if (!s->aux) s->aux = malloc(sizeof(int) * n);
     if (!s->stackL) s->stackL = malloc(sizeof(int) * n);
     if (!s->stackR) s->stackR = malloc(sizeof(int) * n);
-    for (int idx = 0; idx < n; idx++) s->values[idx] = 10 + rand() % SORT_MAX_VALUE;
+    for (int idx = 0; idx < n; idx++) s->values[idx] = 10 + (int)rng_below(rng, SORT_MAX_VALUE);
     qol_timer_start(&s->timer);
 }
 
@@ -58,16 +60,21 @@ static void draw_bars(const SortState *s, int screenW, int screenH) {
     }
 }
 
-void sort(void) {
+// sort [seed]: the seed overrides SORT_SEED; the one used is logged so the
+// same bars (and every reset after them) can be replayed
+void sort(int argc, char **argv) {
     const int SCREEN_W = 1000;
     const int SCREEN_H = 720;
     const int N = 120;
 
-    unsigned int seed_value = (unsigned int)time(NULL);
-    srand(seed_value);
+    uint64_t seed_value = (SORT_SEED == -1) ? (uint64_t)time(NULL) : (uint64_t)SORT_SEED;
+    if (argc > 0) seed_value = strtoull(argv[0], NULL, 10);
+    qol_info("%s on %d values, seed %llu\n", SORT_ALGO_NAME, N, (unsigned long long)seed_value);
+    Rng rng;
+    rng_seed(&rng, seed_value);
 
     SortState state = {0};
-    sort_state_reset_common(&state, N);
+    sort_state_reset_common(&state, N, &rng);
     sort_init(&state);
 
     float tickTime = 0.0f;
@@ -78,7 +85,7 @@ void sort(void) {
     while (!WindowShouldClose()) {
         BeginDrawing();
             if (IsKeyPressed(KEY_R)) {
-                sort_state_reset_common(&state, N);
+                sort_state_reset_common(&state, N, &rng);
                 sort_init(&state);
             }
 
@@ -0,0 +1,556 @@
+#pragma once
+#include "maze.h"
+#include "algorithms/maze/movingai.h"
+#include "algorithms/maze/analytics.h"
+
+static bool parse_maze_size(const char *arg, int *out) {
+    char *end = NULL;
+    long v = strtol(arg, &end, 10);
+    if (!end || *end != '\0' || v < 3 || v > INT_MAX - 64 || v % 2 == 0) {
+        qol_error("Invalid maze size '%s' (odd number >= 3 expected)\n", arg);
+        return false;
+    }
+    *out = (int)v;
+    return true;
+}
+
+// Whether arg is a whole decimal integer, so it can be told apart from a
+// file name that merely starts with a digit
+static bool is_integer_arg(const char *arg) {
+    char *end = NULL;
+    strtol(arg, &end, 10);
+    return end != arg && *end == '\0';
+}
+
+// Write str as a JSON string literal, quotes included
+static void print_json_string(const char *str) {
+    putchar('"');
+    for (const unsigned char *c = (const unsigned char *)str; *c; c++) {
+        if (*c == '"' || *c == '\\') printf("\\%c", *c);
+        else if (*c < 0x20) printf("\\u%04x", *c);
+        else putchar(*c);
+    }
+    putchar('"');
+}
+
+static MazeGen parse_generator(const char *arg) {
+    for (int g = 0; g < GEN_COUNT; g++) {
+        if (strncasecmp(arg, GEN_NAMES[g], strlen(arg)) == 0) return (MazeGen)g;
+    }
+    qol_warn("Unknown generator '%s', using %s\n", arg, GEN_NAMES[GENERATOR]);
+    return GENERATOR;
+}
+
+// Dijkstra and A* open set by name prefix (see QUEUE_NAMES)
+static SearchQueue parse_queue(const char *arg) {
+    for (int q = 0; q < QUEUE_COUNT; q++) {
+        if (strncasecmp(arg, QUEUE_NAMES[q], strlen(arg)) == 0) return (SearchQueue)q;
+    }
+    qol_warn("Unknown queue '%s', using %s\n", arg, QUEUE_NAMES[QUEUE_BINARY]);
+    return QUEUE_BINARY;
+}
+
+// maze-stream <width> <height> <out> [seed]
+// Writes a maze file row by row with Eller's algorithm, so memory stays
+// O(width) however tall the maze is. "-" writes to stdout. Start and goal
+// are the top-left and bottom-right rooms.
+void maze_stream(int argc, char **argv) {
+    if (argc < 3) {
+        qol_error("Usage: maze-stream <width> <height> <out|-> [seed]\n");
+        return;
+    }
+    int width, height;
+    if (!parse_maze_size(argv[0], &width) || !parse_maze_size(argv[1], &height)) return;
+    uint64_t seed = argc > 3 ? strtoull(argv[3], NULL, 10) : (uint64_t)time(NULL);
+
+    bool toStdout = strcmp(argv[2], "-") == 0;
+    FILE *f = toStdout ? stdout : fopen(argv[2], "wb");
+    if (!f) {
+        qol_error("Could not open %s\n", argv[2]);
+        return;
+    }
+
+    MazeFileHeader h;
+    maze_file_header_init(&h, width, height, GEN_ELLER, seed);
+    h.startX = 1;
+    h.startY = 1;
+    h.goalX = width - 2;
+    h.goalY = height - 2;
+    if (!maze_file_write_header(f, &h)) {
+        qol_error("Failed to write maze header\n");
+        if (!toStdout) fclose(f);
+        return;
+    }
+
+    QOL_Timer t;
+    qol_timer_start(&t);
+    GenerateMazeStream(width, height, seed, file_row_sink, f);
+    double dt = qol_timer_elapsed(&t);
+    if (!toStdout) fclose(f);
+
+    qol_info("Streamed %d x %d maze (seed %llu) in %.3fs, %.2f Mcells/s\n",
+             width, height, (unsigned long long)seed, dt, (double)width * height / dt / 1e6);
+}
+
+// maze-save <out> [N] [seed] [generator]
+// Generate a maze plus start/goal exactly like the visualizer does and store
+// it in the maze file format.
+void maze_save(int argc, char **argv) {
+    if (argc < 1) {
+        qol_error("Usage: maze-save <out> [N] [seed] [generator]\n");
+        return;
+    }
+    int N = 1023;
+    if (argc > 1 && !parse_maze_size(argv[1], &N)) return;
+    uint64_t seed = argc > 2 ? strtoull(argv[2], NULL, 10) : (uint64_t)time(NULL);
+    MazeGen gen = argc > 3 ? parse_generator(argv[3]) : GENERATOR;
+
+    Rng rng;
+    rng_seed(&rng, seed);
+    Grid maze;
+    grid_init(&maze, N);
+    grid_clear(&maze);
+    GenerateMazeWith(&maze, gen, &rng);
+    int startX, startY, goalX, goalY;
+    PickEndpoints(&maze, &rng, N, &startX, &startY, &goalX, &goalY);
+
+    MazeFileHeader h;
+    maze_file_header_init(&h, N, N, gen, seed);
+    h.startX = startX;
+    h.startY = startY;
+    h.goalX = goalX;
+    h.goalY = goalY;
+    if (maze_file_save(argv[0], &maze, &h)) {
+        qol_info("Saved %d x %d %s maze (seed %llu) to %s\n",
+                 N, N, GEN_NAMES[gen], (unsigned long long)seed, argv[0]);
+    }
+    grid_free(&maze);
+}
+
+// maze-load <file> [queue]
+// Map a maze file read-only and solve it in place with the selected
+// algorithm (Dijkstra and A* over the named queue); the cells are never
+// copied. The search reads the mapped grid directly rather than building
+// neighbour masks, which would be one more byte per cell resident.
+void maze_load(int argc, char **argv) {
+    if (argc < 1) {
+        qol_error("Usage: maze-load <file> [queue]\n");
+        return;
+    }
+    SearchQueue queue = argc > 1 ? parse_queue(argv[1]) : QUEUE_BINARY;
+    QOL_Timer t;
+    qol_timer_start(&t);
+    MazeFile mf;
+    if (!maze_file_open(argv[0], &mf)) return;
+    double loadTime = qol_timer_elapsed(&t);
+
+    const MazeFileHeader *h = &mf.header;
+    const char *genName = h->generator < GEN_COUNT ? GEN_NAMES[h->generator] : "unknown";
+    qol_info("Mapped %s: %u x %u, %s, seed %llu, %.1f MB in %.3f ms\n", argv[0], h->width, h->height,
+             genName, (unsigned long long)h->seed, (double)mf.mapSize / (1024.0 * 1024.0), loadTime * 1e3);
+    if (h->width != h->height) {
+        qol_error("Only square mazes can be solved (got %u x %u)\n", h->width, h->height);
+        maze_file_close(&mf);
+        return;
+    }
+    int N = (int)h->width;
+    if (!search_size_ok(N)) {
+        maze_file_close(&mf);
+        return;
+    }
+    if (h->startX < 0 || h->startX >= N || h->startY < 0 || h->startY >= N ||
+        h->goalX < 0 || h->goalX >= N || h->goalY < 0 || h->goalY >= N) {
+        qol_error("Start/goal outside the maze\n");
+        maze_file_close(&mf);
+        return;
+    }
+
+    Rng rng;
+    rng_seed(&rng, h->seed);
+    SearchState state = {0};
+    qol_timer_start(&t);
+    search_init(&state, N, &mf.grid, h->startX, h->startY, h->goalX, h->goalY, &rng);
+    search_set_queue(&state, queue);
+    double initTime = qol_timer_elapsed(&t);
+    long steps = 0;
+    qol_timer_start(&t);
+    bool found = RunSearch(&state, &steps);
+    double solveTime = qol_timer_elapsed(&t);
+
+    long visited = 0;
+    for (int i = 0; i < state.max; i++) visited += state.visited[i] != 0;
+    if (found) {
+        qol_info("%s (%s queue): path len %zu, steps %ld, visited %ld, init %.3fs, solve %.3fs\n",
+                 ALGO_NAME, QUEUE_NAMES[queue], state.path.len, steps, visited, initTime, solveTime);
+    } else {
+        qol_warn("%s: goal unreachable after %ld steps (visited %ld, %.3fs)\n", ALGO_NAME, steps, visited, solveTime);
+    }
+    search_free(&state);
+    maze_file_close(&mf);
+}
+
+static bool parse_world_coord(const char *arg, int *out) {
+    char *end = NULL;
+    long v = strtol(arg, &end, 10);
+    if (!end || *end != '\0' || v < INT_MIN / 2 || v > INT_MAX / 2) {
+        qol_error("Invalid world coordinate '%s'\n", arg);
+        return false;
+    }
+    *out = (int)(v | 1); // snap to a room
+    return true;
+}
+
+// A search whose chunk cache generates more than one chunk per this many
+// steps is thrashing: a chunk holds about 2k open cells, so a cache that
+// keeps up generates one per thousands of steps
+#define WORLD_THRASH_STEPS 64
+
+// maze-world <x0> <y0> <x1> <y1> [seed] [cache chunks]
+// Solve between two world cells of the unbounded chunked maze. The search
+// window is the chunk-aligned bounding box plus one chunk of margin, which
+// is always connected; cells are produced by a chunk cache of fixed size.
+// The cache bounds the maze's memory, not the search's: the search state
+// grows with the cells expanded (about 28 bytes each plus the cell map)
+// and is only bounded by the window. The cache is raised to at least four
+// chunks per chunk of window span, roughly what a search front crossing
+// the window touches, and a run that still regenerates chunks faster than
+// WORLD_THRASH_STEPS allows is stopped and reported.
+void maze_world(int argc, char **argv) {
+    if (argc < 4) {
+        qol_error("Usage: maze-world <x0> <y0> <x1> <y1> [seed] [cache chunks]\n");
+        return;
+    }
+    int x0, y0, x1, y1;
+    if (!parse_world_coord(argv[0], &x0) || !parse_world_coord(argv[1], &y0) ||
+        !parse_world_coord(argv[2], &x1) || !parse_world_coord(argv[3], &y1)) return;
+    uint64_t seed = argc > 4 ? strtoull(argv[4], NULL, 10) : (uint64_t)time(NULL);
+    int cache = argc > 5 ? atoi(argv[5]) : 256;
+
+    int originX = ((x0 < x1 ? x0 : x1) >> CHUNK_BITS) - 1;
+    int originY = ((y0 < y1 ? y0 : y1) >> CHUNK_BITS) - 1;
+    int spanX = ((x0 > x1 ? x0 : x1) >> CHUNK_BITS) + 2 - originX;
+    int spanY = ((y0 > y1 ? y0 : y1) >> CHUNK_BITS) + 2 - originY;
+    int span = spanX > spanY ? spanX : spanY;
+    // Window coordinates and greedy's h in [0, 2N - 2] must fit an int
+    if ((long)span * CHUNK_SIZE > INT_MAX / 2) {
+        qol_error("Points are too far apart (window of %ld cells)\n", (long)span * CHUNK_SIZE);
+        return;
+    }
+    int N = span * CHUNK_SIZE;
+    originX *= CHUNK_SIZE;
+    originY *= CHUNK_SIZE;
+    if (cache < 4 * span) {
+        qol_warn("Cache of %d chunks cannot hold a search front across %d chunks, using %d\n", cache, span, 4 * span);
+        cache = 4 * span;
+    }
+
+    ChunkSource chunks;
+    chunk_source_init(&chunks, seed, cache);
+    Rng rng;
+    rng_seed(&rng, seed);
+    SearchState state = {0};
+    search_init_chunked(&state, N, &chunks, originX, originY, x0 - originX, y0 - originY, x1 - originX, y1 - originY, &rng);
+
+    // RunSearch() with a check every 64k steps that the cache keeps up
+    long steps = 0;
+    long limit = search_cell_bound(&state) + 1;
+    bool found = false, thrashing = false;
+    QOL_Timer t;
+    qol_timer_start(&t);
+    for (steps = 1; steps <= limit; steps++) {
+        if (step(&state)) {
+            found = true;
+            break;
+        }
+        if ((steps & 0xffff) == 0 && chunks.misses > steps / WORLD_THRASH_STEPS) {
+            thrashing = true;
+            break;
+        }
+    }
+    double dt = qol_timer_elapsed(&t);
+
+    qol_info("Window %d x %d at (%d, %d), seed %llu\n", N, N, originX, originY, (unsigned long long)seed);
+    if (found) {
+        qol_info("%s: path len %zu, steps %ld, %.3fs\n", ALGO_NAME, state.path.len, steps, dt);
+    } else if (thrashing) {
+        qol_error("%s: stopped after %ld steps (%.3fs), the %d-chunk cache regenerated %ld chunks; "
+                  "pass a larger cache\n", ALGO_NAME, steps, dt, cache, chunks.misses);
+    } else {
+        qol_warn("%s: goal unreachable after %ld steps (%.3fs)\n", ALGO_NAME, steps, dt);
+    }
+    qol_info("Chunks: %d cached (%.1f KB), %ld hits, %ld generated\n", chunks.count,
+             (double)chunk_source_bytes(&chunks) / 1024.0, chunks.hits, chunks.misses);
+    qol_info("Search: %d cells touched, %.1f MB of state\n", state.cells.count,
+             (double)search_bytes(&state) / (1024.0 * 1024.0));
+    search_free(&state);
+    chunk_source_free(&chunks);
+}
+
+// maze-scen <file.scen> [map dir]
+// Run every Moving AI scenario with the selected algorithm. Each path is
+// checked for validity and against a reference BFS; the report gives
+// expansions, solve time per query, suboptimality against the 4-connected
+// optimum and the ratio to the published octile optimum. Maps are looked up
+// next to the .scen unless a directory is given.
+void maze_scen(int argc, char **argv) {
+    if (argc < 1) {
+        qol_error("Usage: maze-scen <file.scen> [map dir]\n");
+        return;
+    }
+    MovingAiScen scen = {0};
+    if (!movingai_load_scen(argv[0], &scen)) return;
+    if (scen.len == 0) {
+        qol_error("%s has no scenarios\n", argv[0]);
+        qol_release(&scen);
+        return;
+    }
+
+    char dir[512];
+    if (argc > 1) {
+        snprintf(dir, sizeof(dir), "%s", argv[1]);
+    } else {
+        snprintf(dir, sizeof(dir), "%s", argv[0]);
+        char *slash = strrchr(dir, '/');
+        if (slash) *slash = '\0';
+        else snprintf(dir, sizeof(dir), ".");
+    }
+
+    Rng rng;
+    rng_seed(&rng, 1);
+    Grid grid = {0};
+    ComponentIndex comps = {0};
+    NeighborMasks masks = {0};
+    MovingAiBfs reference = {0};
+    char loaded[256] = "";
+    bool mapOk = false;    // whether the map named by loaded is in grid
+    int width = 0, height = 0;
+    long searched = 0, solved = 0, invalid = 0, suboptimal = 0, expansions = 0, disconnected = 0;
+    double solveTime = 0.0, subSum = 0.0, octileSum = 0.0;
+
+    for (size_t i = 0; i < scen.len; i++) {
+        MovingAiQuery *q = &scen.data[i];
+        if (strcmp(q->map, loaded) != 0) {
+            const char *base = strrchr(q->map, '/');
+            char path[1024];
+            snprintf(path, sizeof(path), "%s/%s", dir, base ? base + 1 : q->map);
+            if (mapOk) {
+                grid_free(&grid);
+                components_free(&comps);
+                neighbor_masks_free(&masks);
+                movingai_bfs_free(&reference);
+            }
+            snprintf(loaded, sizeof(loaded), "%s", q->map);
+            mapOk = movingai_load_map(path, &grid, &width, &height);
+            if (mapOk && !layout_fits(SEARCH_LAYOUT, grid.N)) {
+                qol_warn("%s is too large to search (%d x %d)\n", path, width, height);
+                grid_free(&grid);
+                mapOk = false;
+            }
+            if (mapOk) {
+                components_build(&comps, &grid, 0);
+                neighbor_masks_init(&masks, grid.N);
+                neighbor_masks_build(&masks, &grid);
+                movingai_bfs_init(&reference, grid.N);
+                qol_info("Loaded %s (%d x %d)\n", path, width, height);
+            } else {
+                qol_warn("Skipping the queries on %s\n", q->map);
+            }
+        }
+        if (!mapOk) {
+            invalid++;
+            continue;
+        }
+        if (q->width != width || q->height != height ||
+            q->startX < 0 || q->startX >= width || q->startY < 0 || q->startY >= height ||
+            q->goalX < 0 || q->goalX >= width || q->goalY < 0 || q->goalY >= height) {
+            qol_warn("Query %zu does not fit %s, skipped\n", i, q->map);
+            invalid++;
+            continue;
+        }
+
+        SearchState state = {0};
+        search_init(&state, grid.N, &grid, q->startX, q->startY, q->goalX, q->goalY, &rng);
+        search_set_masks(&state, &masks);
+        if (!search_check_components(&state, &comps)) disconnected++;
+        long steps = 0;
+        QOL_Timer t;
+        qol_timer_start(&t);
+        bool found = RunSearch(&state, &steps);
+        solveTime += qol_timer_elapsed(&t);
+        expansions += steps;
+        searched++;
+
+        int best = state.unreachable ? -1 : movingai_grid_distance(&grid, &reference, q->startX, q->startY, q->goalX, q->goalY);
+        if (!found) {
+            if (best >= 0) {
+                qol_warn("Query %zu: no path found, reference length %d\n", i, best);
+                invalid++;
+            }
+        } else if (!movingai_path_valid(&grid, state.path.data, state.path.len, q->startX, q->startY, q->goalX, q->goalY)) {
+            qol_warn("Query %zu: returned path is broken\n", i);
+            invalid++;
+        } else {
+            int moves = (int)state.path.len - 1;
+            solved++;
+            if (moves > best) suboptimal++;
+            subSum += best > 0 ? (double)moves / best : 1.0;
+            octileSum += q->optimal > 0.0 ? moves / q->optimal : 1.0;
+        }
+        search_free(&state);
+    }
+
+    qol_info("%s on %s: %ld/%zu solved, %ld invalid, %ld suboptimal, %ld disconnected\n",
+             ALGO_NAME, argv[0], solved, scen.len, invalid, suboptimal, disconnected);
+    if (solved > 0) {
+        qol_info("  %.1f expansions/query, %.3f ms/query over %ld searched\n", (double)expansions / (double)searched,
+                 solveTime * 1e3 / (double)searched, searched);
+        qol_info("  mean length vs 4-connected optimum %.4f, vs octile optimum %.4f\n", subSum / solved, octileSum / solved);
+    }
+    if (mapOk) {
+        grid_free(&grid);
+        components_free(&comps);
+        neighbor_masks_free(&masks);
+        movingai_bfs_free(&reference);
+    }
+    qol_release(&scen);
+}
+
+// maze-terrain [N] [seed] [max cost] [queue]
+// Weighted workload: an open N x N field whose cells cost 1..max cost from
+// fractal noise, solved corner to corner by the selected algorithm.
+// Dijkstra and A* follow the costs, over the named queue (see pqueue.h);
+// the others ignore both.
+void maze_terrain(int argc, char **argv) {
+    int N = 511;
+    if (argc > 0 && !parse_maze_size(argv[0], &N)) return;
+    uint64_t seed = argc > 1 ? strtoull(argv[1], NULL, 10) : (uint64_t)time(NULL);
+    int maxCost = argc > 2 ? atoi(argv[2]) : 255;
+    SearchQueue queue = argc > 3 ? parse_queue(argv[3]) : QUEUE_BINARY;
+    if (!search_size_ok(N)) return;
+
+    Rng rng;
+    rng_seed(&rng, seed);
+    Grid field;
+    grid_init(&field, N);
+    grid_clear(&field);
+    for (int y = 0; y < N; y++) {
+        for (int x = 0; x < N; x++) grid_set(&field, x, y, PATH);
+    }
+    CostGrid costs;
+    cost_grid_init(&costs, N);
+    GenerateTerrainCosts(&costs, &rng, maxCost);
+
+    SearchState state = {0};
+    NeighborMasks masks;
+    neighbor_masks_init(&masks, N);
+    neighbor_masks_build(&masks, &field);
+    search_init(&state, N, &field, 0, 0, N - 1, N - 1, &rng);
+    search_set_costs(&state, &costs);
+    search_set_masks(&state, &masks);
+    search_set_queue(&state, queue);
+    long steps = 0;
+    QOL_Timer t;
+    qol_timer_start(&t);
+    bool found = RunSearch(&state, &steps);
+    double dt = qol_timer_elapsed(&t);
+
+    if (found) {
+        qol_info("%s (%s queue) on %d x %d terrain (costs %d..%d, seed %llu): path cost %ld, len %zu, %ld expansions, %.3fs\n",
+                 ALGO_NAME, QUEUE_NAMES[queue], N, N, costs.min, maxCost, (unsigned long long)seed, search_path_cost(&state),
+                 state.path.len, steps, dt);
+    } else {
+        qol_warn("%s: no path found (%ld steps)\n", ALGO_NAME, steps);
+    }
+    search_free(&state);
+    neighbor_masks_free(&masks);
+    cost_grid_free(&costs);
+    grid_free(&field);
+}
+
+// maze-stats [N] [seed] [generator] [threads]
+// maze-stats <file> [threads]
+// Structural statistics of a generated (or saved) maze as JSON on stdout:
+// degree histogram, dead ends, corridor lengths and the diameter.
+void maze_stats(int argc, char **argv) {
+    const char *file = argc > 0 && !is_integer_arg(argv[0]) ? argv[0] : NULL;
+    int N = 1023;
+    uint64_t seed = (uint64_t)time(NULL);
+    MazeGen gen = GENERATOR;
+    int threads = 0;
+    if (file) {
+        if (argc > 1) threads = atoi(argv[1]);
+    } else {
+        if (argc > 0 && !parse_maze_size(argv[0], &N)) return;
+        if (argc > 1) seed = strtoull(argv[1], NULL, 10);
+        if (argc > 2) gen = parse_generator(argv[2]);
+        if (argc > 3) threads = atoi(argv[3]);
+    }
+
+    QOL_Timer t;
+    qol_timer_start(&t);
+    Grid maze = {0};
+    MazeFile mf;
+    const Grid *g = &maze;
+    if (file) {
+        if (!maze_file_open(file, &mf)) return;
+        if (mf.header.width != mf.header.height) {
+            qol_error("Only square mazes are supported (got %u x %u)\n", mf.header.width, mf.header.height);
+            maze_file_close(&mf);
+            return;
+        }
+        g = &mf.grid;
+        seed = mf.header.seed;
+        gen = mf.header.generator < GEN_COUNT ? (MazeGen)mf.header.generator : GEN_COUNT;
+    } else {
+        Rng rng;
+        rng_seed(&rng, seed);
+        grid_init(&maze, N);
+        grid_clear(&maze);
+        GenerateMazeWith(&maze, gen, &rng);
+    }
+    double prepare = qol_timer_elapsed(&t);
+
+    qol_timer_start(&t);
+    MazeStats st;
+    analytics_run(&st, g, threads);
+    double analyze = qol_timer_elapsed(&t);
+
+    int buckets = ANALYTICS_BUCKETS;
+    while (buckets > 1 && st.corridorHist[buckets - 1] == 0) buckets--;
+    printf("{\n");
+    if (file) {
+        printf("  \"file\": ");
+        print_json_string(file);
+        printf(",\n");
+    }
+    printf("  \"generator\": \"%s\",\n", gen < GEN_COUNT ? GEN_NAMES[gen] : "unknown");
+    printf("  \"seed\": %llu,\n", (unsigned long long)seed);
+    printf("  \"N\": %d,\n", st.N);
+    printf("  \"open\": %ld,\n", st.open);
+    printf("  \"edges\": %ld,\n", st.edges);
+    printf("  \"perfect\": %s,\n", st.perfect ? "true" : "false");
+    printf("  \"dead_ends\": %ld,\n", st.degree[1]);
+    printf("  \"junctions\": %ld,\n", st.degree[3] + st.degree[4]);
+    printf("  \"degree\": [%ld, %ld, %ld, %ld, %ld],\n", st.degree[0], st.degree[1], st.degree[2], st.degree[3], st.degree[4]);
+    printf("  \"corridors\": {\n");
+    printf("    \"count\": %ld,\n", st.corridors);
+    printf("    \"mean\": %.3f,\n", st.corridors ? (double)st.corridorTotal / st.corridors : 0.0);
+    printf("    \"max\": %ld,\n", st.corridorMax);
+    printf("    \"histogram\": [");
+    for (int k = 0; k < buckets; k++) {
+        printf("%s{\"min\": %ld, \"max\": %ld, \"count\": %ld}", k ? ", " : "", 1L << k, (2L << k) - 1, st.corridorHist[k]);
+    }
+    printf("]\n  },\n");
+    printf("  \"diameter\": {\n");
+    printf("    \"length\": %d,\n", st.diameter);
+    printf("    \"exact\": %s,\n", st.perfect ? "true" : "false");
+    printf("    \"from\": [%d, %d],\n", st.fromX, st.fromY);
+    printf("    \"to\": [%d, %d],\n", st.toX, st.toY);
+    printf("    \"reached\": %ld\n", st.reached);
+    printf("  },\n");
+    printf("  \"seconds\": {\"%s\": %.3f, \"analyze\": %.3f}\n", file ? "load" : "generate", prepare, analyze);
+    printf("}\n");
+
+    if (file) maze_file_close(&mf);
+    else grid_free(&maze);
+}